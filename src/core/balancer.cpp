@@ -0,0 +1,237 @@
+#include "core/balancer.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace core {
+
+static constexpr std::size_t kMaxHistory = 256;
+
+static int64_t clock_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Balancer::Balancer(const std::vector<Thread*>& threads, Object* parent)
+    : Balancer(threads, Options(), parent) {}
+
+Balancer::Balancer(const std::vector<Thread*>& threads,
+                   const Options& options,
+                   Object* parent)
+    : Object(parent),
+      options_(options),
+      threads_(threads),
+      samples_(threads.size()),
+      last_ts_(clock_ns()),
+      timer_([this](const Event*) { balance(); }, this) {
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    profiling_.push_back(threads_[i]->setProfiling(true));
+    samples_[i].stats_ = threads_[i]->load();
+    samples_[i].load_ = 0;
+  }
+}
+
+Balancer::~Balancer() {
+  stop();
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->setProfiling(profiling_[i]);
+  }
+}
+
+void Balancer::manage(const Trigger& trigger, Object* owner) {
+  auto p = trigger.pimpl_.lock();
+  if (!p) {
+    return;
+  }
+
+  std::scoped_lock lck(mtx_);
+  entries_.push_back(Entry{p, owner, p->cost_.load(), 0});
+}
+
+void Balancer::start() {
+  timer_.start(options_.interval);
+}
+
+void Balancer::stop() {
+  timer_.stop();
+}
+
+void Balancer::balance() {
+  auto now = clock_ns();
+  auto elapsed = now - last_ts_;
+  last_ts_ = now;
+  if (elapsed <= 0 || threads_.size() < 2) {
+    return;
+  }
+  // 迁移在源线程中异步完成，其后一个周期的负载跨越迁移过程，不作判断
+  if (settling_) {
+    settling_ = false;
+    rebase();
+    return;
+  }
+
+  std::size_t hot = 0;
+  std::size_t cold = 0;
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    auto stats = threads_[i]->load();
+    auto busy = stats.busy_ns - samples_[i].stats_.busy_ns;
+    auto wait = stats.wait_ns - samples_[i].stats_.wait_ns;
+    samples_[i].stats_ = stats;
+    // 整个周期阻塞在等待中的线程尚未累计等待时间，视为空闲
+    samples_[i].load_ =
+        busy + wait > 0 ? static_cast<double>(busy) / (busy + wait) : 0.0;
+    if (samples_[i].load_ > samples_[hot].load_) {
+      hot = i;
+    }
+    if (samples_[i].load_ < samples_[cold].load_) {
+      cold = i;
+    }
+  }
+
+  auto hot_load = samples_[hot].load_;
+  auto cold_load = samples_[cold].load_;
+  auto gap = hot_load - cold_load;
+
+  std::vector<Migration> moved;
+  Observer observer;
+  {
+    std::scoped_lock lck(mtx_);
+    observer = observer_;
+
+    struct Candidate {
+      Entry* entry_;
+      std::shared_ptr<IOEvent> event_;
+      double heat_;
+    };
+    std::vector<Candidate> candidates;
+
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const Entry& e) {
+                                    return e.event_.expired();
+                                  }),
+                   entries_.end());
+    for (auto& e : entries_) {
+      auto p = e.event_.lock();
+      if (!p) {
+        continue;
+      }
+      auto cost = p->cost_.load();
+      auto heat = static_cast<double>(cost - e.cost_) / elapsed;
+      e.cost_ = cost;
+      if (e.cooldown_ > 0) {
+        --e.cooldown_;
+        continue;
+      }
+      if (heat > 0 && p->thd_ == threads_[hot]) {
+        candidates.push_back(Candidate{&e, p, heat});
+      }
+    }
+
+    // 失衡需持续confirm个周期，恢复需低于settle，避免来回迁移
+    if (gap > options_.imbalance) {
+      ++unbalanced_;
+    } else if (gap < options_.settle) {
+      unbalanced_ = 0;
+    }
+    if (unbalanced_ < options_.confirm) {
+      return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& l, const Candidate& r) {
+                return l.heat_ > r.heat_;
+              });
+
+    for (auto& c : candidates) {
+      if (static_cast<int>(moved.size()) >= options_.max_moves ||
+          gap < options_.settle) {
+        break;
+      }
+      // 迁移后反向失衡不小于当前失衡，没有收益
+      if (c.heat_ >= gap) {
+        continue;
+      }
+
+      char reason[128];
+      snprintf(reason, sizeof(reason),
+               "load %.2f vs %.2f for %d periods, event heat %.2f",
+               hot_load, cold_load, unbalanced_, c.heat_);
+      moved.push_back(Migration{c.event_->fd_, threads_[hot], threads_[cold],
+                                c.heat_, hot_load, cold_load, reason});
+
+      migrate(c.event_, c.entry_->owner_, threads_[hot], threads_[cold]);
+      c.entry_->cooldown_ = options_.cooldown;
+
+      hot_load -= c.heat_;
+      cold_load += c.heat_;
+      gap = std::abs(hot_load - cold_load);
+    }
+
+    if (!moved.empty()) {
+      unbalanced_ = 0;
+      settling_ = true;
+      history_.insert(history_.end(), moved.begin(), moved.end());
+      if (history_.size() > kMaxHistory) {
+        history_.erase(history_.begin(),
+                       history_.begin() + (history_.size() - kMaxHistory));
+      }
+    }
+  }
+
+  // 本周期的负载在迁移前测得，下个周期从迁移时开始
+  if (!moved.empty()) {
+    rebase();
+  }
+
+  if (observer) {
+    for (auto const& m : moved) {
+      observer(m);
+    }
+  }
+}
+
+void Balancer::rebase() {
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    samples_[i].stats_ = threads_[i]->load();
+    samples_[i].load_ = 0;
+  }
+  last_ts_ = clock_ns();
+
+  std::scoped_lock lck(mtx_);
+  for (auto& e : entries_) {
+    if (auto p = e.event_.lock()) {
+      e.cost_ = p->cost_.load();
+    }
+  }
+}
+
+// Object的归属线程只由其所在线程修改，迁移在源线程中执行
+void Balancer::migrate(const std::shared_ptr<IOEvent>& event,
+                       Object* owner,
+                       Thread* from,
+                       Thread* to) {
+  from->post([event = std::weak_ptr<IOEvent>(event), owner, from, to]() {
+    // 事件已移除或已被迁走时，owner也不再随之迁移
+    auto p = event.lock();
+    if (!p || p->thd_ != from) {
+      return;
+    }
+    if (owner) {
+      owner->moveToThread(to);
+    }
+    Trigger::moveToThread(p, to);
+  });
+}
+
+void Balancer::setObserver(const Observer& observer) {
+  std::scoped_lock lck(mtx_);
+  observer_ = observer;
+}
+
+std::vector<Balancer::Migration> Balancer::history() const {
+  std::scoped_lock lck(mtx_);
+  return history_;
+}
+
+}  // namespace core
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/event.h"
+#include "core/object.h"
+#include "core/thread.h"
+#include "core/timer.h"
+
+namespace core {
+
+/**
+ * @brief
+ * 事件循环间的负载均衡器。
+ * 周期性比较各线程的利用率，失衡持续若干周期后，
+ * 将热点线程上最热的可迁移事件迁往最空闲的线程。
+ * 只有通过manage登记的事件会被迁移。
+ * balance()只作出迁移决定，迁移由源线程在其事件循环中完成，
+ * 其后的一个周期只重新取样，不以跨越迁移过程的负载作判断。
+ */
+class Balancer : public Object {
+  META_OBJECT(Balancer, Object)
+
+ public:
+  struct Options {
+    int64_t interval = 1000000;  // 采样周期(us)
+    double imbalance = 0.25;     // 利用率差超过该值视为失衡
+    double settle = 0.1;         // 利用率差低于该值视为恢复均衡
+    int confirm = 2;             // 连续失衡多少个周期后迁移
+    int cooldown = 5;            // 迁移过的事件多少个周期内不再迁移
+    int max_moves = 8;           // 每个周期最多迁移的事件数
+  };
+
+  struct Migration {
+    int fd;
+    Thread const* from;
+    Thread const* to;
+    double heat;       // 事件在上个周期占用的CPU比例
+    double from_load;  // 迁移前源线程利用率
+    double to_load;    // 迁移前目标线程利用率
+    std::string reason;
+  };
+
+  using Observer = std::function<void(const Migration&)>;
+
+  explicit Balancer(const std::vector<Thread*>& threads,
+                    Object* parent = nullptr);
+  Balancer(const std::vector<Thread*>& threads,
+           const Options& options,
+           Object* parent = nullptr);
+  ~Balancer() override;
+
+  /**
+   * @brief
+   * 登记可迁移的事件，owner不为空时随事件一起迁移。
+   * 迁移在事件所在的线程中执行，owner须在事件移除前一直有效
+   */
+  void manage(const Trigger& trigger, Object* owner = nullptr);
+
+  void start();
+  void stop();
+
+  // 执行一次采样与均衡，通常由内部定时器调用
+  void balance();
+
+  void setObserver(const Observer& observer);
+  std::vector<Migration> history() const;
+
+ private:
+  struct Entry {
+    std::weak_ptr<IOEvent> event_;
+    Object* owner_;
+    int64_t cost_;
+    int cooldown_;
+  };
+
+  static void migrate(const std::shared_ptr<IOEvent>& event,
+                      Object* owner,
+                      Thread* from,
+                      Thread* to);
+
+  // 以当前的累计负载与事件耗时作为下个周期的起点
+  void rebase();
+
+  struct Sample {
+    Poller::LoadStats stats_;
+    double load_;
+  };
+
+  Options options_;
+  std::vector<Thread*> threads_;
+  std::vector<Sample> samples_;
+  // 各线程在构造前的profiling状态，析构时恢复
+  std::vector<bool> profiling_;
+  int unbalanced_ = 0;
+  // 上个周期有迁移，下个周期只重新取样
+  bool settling_ = false;
+  int64_t last_ts_;
+
+  mutable std::mutex mtx_;
+  std::vector<Entry> entries_;
+  std::vector<Migration> history_;
+  Observer observer_;
+
+  Timer timer_;
+};
+
+}  // namespace core
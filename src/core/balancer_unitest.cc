@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+
+#include "core/balancer.h"
+#include "core/thread.h"
+
+static void spin(int64_t us) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+TEST(Balancer, MoveHotEvents) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+
+  core::Balancer::Options options;
+  options.confirm = 1;
+  core::Balancer balancer({&a, &b}, options);
+
+  constexpr int size = 4;
+  std::atomic<int> on_b = 0;
+  std::vector<core::Trigger> triggers;
+  triggers.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    triggers.emplace_back(
+        a.addEvent(core::Events::Execute, [&](const core::Event*) {
+          spin(1000);
+          if (core::Thread::this_thread() == &b) {
+            ++on_b;
+          }
+        }));
+    balancer.manage(triggers.back());
+  }
+
+  // a满载，b空闲
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto& t : triggers) {
+      t.trigger();
+    }
+    usleep(500);
+  }
+
+  std::vector<core::Balancer::Migration> observed;
+  balancer.setObserver(
+      [&](const core::Balancer::Migration& m) { observed.push_back(m); });
+  balancer.balance();
+
+  auto history = balancer.history();
+  ASSERT_FALSE(history.empty());
+  EXPECT_LT(history.size(), size);
+  EXPECT_EQ(history.size(), observed.size());
+  for (auto const& m : history) {
+    EXPECT_EQ(m.from, &a);
+    EXPECT_EQ(m.to, &b);
+    EXPECT_GT(m.from_load, m.to_load);
+    EXPECT_FALSE(m.reason.empty());
+  }
+
+  // 迁移完成前的触发可能仍由a处理
+  for (int i = 0; i < 1000 && on_b == 0; ++i) {
+    for (auto& t : triggers) {
+      t.trigger();
+    }
+    usleep(1000);
+  }
+  EXPECT_GT(on_b, 0);
+
+  // 迁移后的周期只重新取样，a仍然满载也不迁移
+  balancer.balance();
+  EXPECT_EQ(balancer.history().size(), history.size());
+
+  // 之后的周期从迁移后开始测量，两个线程都空闲，不再迁移
+  usleep(100000);
+  balancer.balance();
+  EXPECT_EQ(balancer.history().size(), history.size());
+}
+
+TEST(Balancer, RestoreProfiling) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.setProfiling(true);
+  {
+    core::Balancer balancer({&a, &b});
+  }
+  // 恢复为构造前的状态
+  EXPECT_TRUE(a.setProfiling(false));
+  EXPECT_FALSE(b.setProfiling(false));
+}
+
+TEST(Balancer, PostedAndDeferredWork) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+
+  core::Balancer::Options options;
+  options.confirm = 1;
+  core::Balancer balancer({&a, &b}, options);
+
+  // 投递的任务计入线程负载，延后执行的处理函数的耗时计入其事件
+  auto spinning = [](int64_t us) {
+    return [us](const core::Event*) { spin(us); };
+  };
+  std::vector<core::Trigger> triggers;
+  for (int i = 0; i < 2; ++i) {
+    triggers.emplace_back(
+        a.addEvent(core::Events::Execute, spinning(1000), 1000));
+    balancer.manage(triggers.back());
+  }
+  auto before = a.load();
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (std::chrono::steady_clock::now() < end) {
+    a.post([]() { spin(200); });
+    for (auto& t : triggers) {
+      t.trigger();
+    }
+    usleep(500);
+  }
+  auto after = a.load();
+  auto busy = after.busy_ns - before.busy_ns;
+  auto wait = after.wait_ns - before.wait_ns;
+  EXPECT_GT(busy, wait);
+
+  balancer.balance();
+  ASSERT_FALSE(balancer.history().empty());
+  EXPECT_GT(balancer.history().front().heat, 0.1);
+}
@@ -14,13 +14,22 @@ Trigger::Trigger(const EventPtr& ev)
     : pimpl_(std::static_pointer_cast<IOEvent>(ev)) {}
 
 Trigger::~Trigger() {
-  std::cout << "~Trigger" << std::endl;
   auto p = pimpl_.lock();
   if (p) {
-    p->thd_->removeEvent(p->fd_);
+    p->thd_.load()->removeEvent(p);
   }
 }
 
+Trigger& Trigger::operator=(Trigger&& other) noexcept {
+  if (this != &other) {
+    if (auto p = pimpl_.lock()) {
+      p->thd_.load()->removeEvent(p);
+    }
+    pimpl_ = std::move(other.pimpl_);
+  }
+  return *this;
+}
+
 bool Trigger::isValid() const {
   auto p = pimpl_.lock();
   return p && p->fd_ != -1;
@@ -31,42 +40,40 @@ int Trigger::fd() const {
   return p ? p->fd_ : -1;
 }
 
-void Trigger::trigger() const {
+void Trigger::trigger(uint64_t n) const {
   //
   auto cur_thread = Thread::this_thread();
   std::shared_ptr<IOEvent> p;
-  EventStatus status = EventStatus::Listen;
-  while (p = pimpl_.lock()) {
-    if (p->status_.compare_exchange_weak(status, EventStatus::Triggering)) {
-      break;
-    }
+  while ((p = pimpl_.lock()) && p->status_ == EventStatus::NotReady) {
     p = nullptr;
-    status = EventStatus::Listen;
     // 在事件没有被添加到监听队列中时，循环等待其被加入队列。
-    // 等待期间为保证不阻塞当前线程，执行事件循环
+    // 等待期间为保证不阻塞当前线程，执行事件循环。
+    // 迁移中的事件fd保持打开，写入的计数会随fd一起到达目标线程
     cur_thread->processEvents(1);
   }
+  if (!p) {
+    return;
+  }
 
-  uint64_t one = 1;
-  auto size = ::write(p->fd_, &one, sizeof(one));
+  auto size = ::write(p->fd_, &n, sizeof(n));
   UNUSED(size);
-  p->status_ = status;
 }
 
 void Trigger::moveToThread(Thread const* thd) {
-  auto p = pimpl_.lock();
+  moveToThread(pimpl_.lock(), thd);
+}
+
+void Trigger::moveToThread(const std::shared_ptr<IOEvent>& p,
+                           Thread const* thd) {
   if (!p || p->thd_ == thd) {
     return;
   }
 
-  auto cur_thd = Thread::this_thread();
-  p->thd_->removeEvent(p->fd_);
-  auto status = EventStatus::NotReady;
-  while (!p->status_.compare_exchange_weak(status, EventStatus::Moving)) {
-    cur_thd->processEvents(1);
-  }
-
-  pimpl_ = thd->addEvent(p->fd_, p->event_, p->handler_).pimpl_;
+  // 先标记迁移并更新归属，之后的删除与迁移请求都发往新线程
+  auto status = EventStatus::Listen;
+  p->status_.compare_exchange_strong(status, EventStatus::Moving);
+  auto from = p->thd_.exchange(thd);
+  from->moveEvent(p, thd);
 }
 
 }  // namespace core
\ No newline at end of file
@@ -28,12 +28,20 @@ enum class EventType : uint8_t {
   Timer = 1,
 };
 
-struct Event {
+struct Event : public std::enable_shared_from_this<Event> {
   using Handler = std::function<void(const Event*)>;
   Handler handler_;
   int type_;
   std::atomic<EventStatus> status_;
-  Thread const* thd_;
+  // 事件迁移时由发起方更新，可能被多个线程同时读取
+  std::atomic<Thread const*> thd_;
+  // 派发次数与处理累计耗时(ns)，耗时仅在Poller开启统计时记录，
+  // 延后执行的处理函数在执行时通过const Event累加
+  std::atomic<uint64_t> hits_ = 0;
+  mutable std::atomic<int64_t> cost_ = 0;
+  // 本次派发合并的触发次数，Execute事件为两次派发之间trigger的累计值，
+  // 其他事件恒为1，仅在处理函数中有效
+  uint64_t count_ = 1;
 };
 
 struct TimerEvent : public Event {
@@ -41,6 +49,7 @@ struct TimerEvent : public Event {
   int64_t timeout_;
   bool single_shot_;
   int64_t expire_;
+  bool precise_ = false;
 };
 
 struct IOEvent : public Event {
@@ -54,20 +63,30 @@ class Trigger {
  public:
   ~Trigger();
 
+  Trigger(const Trigger&) = delete;
+  Trigger& operator=(const Trigger&) = delete;
+  Trigger(Trigger&&) noexcept = default;
+  Trigger& operator=(Trigger&&) noexcept;
+
   bool isValid() const;
 
   int fd() const;
 
-  void trigger() const;
+  // 累加n次触发，事件循环运行前的多次触发合并为一次派发
+  void trigger(uint64_t n = 1) const;
 
   void moveToThread(Thread const* thd);
 
  private:
   explicit Trigger(const EventPtr& ev);
 
+  static void moveToThread(const std::shared_ptr<IOEvent>& p,
+                           Thread const* thd);
+
   std::weak_ptr<IOEvent> pimpl_;
 
   friend class Thread;
+  friend class Balancer;
 };
 
 }  // namespace core
\ No newline at end of file
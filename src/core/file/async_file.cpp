@@ -0,0 +1,166 @@
+#include "core/file/async_file.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <optional>
+
+#include "core/file/uring.h"
+#include "core/thread.h"
+
+#include "utils/thread/thread_pool.hpp"
+
+namespace core {
+
+static constexpr std::size_t kPoolSize = 4;
+static constexpr unsigned kRingEntries = 256;
+
+struct AsyncFile::Handle {
+  explicit Handle(int fd) : fd_(fd) {}
+  ~Handle() { ::close(fd_); }
+
+  int fd_;
+};
+
+namespace {
+
+std::atomic<AsyncFile::Backend> g_backend = AsyncFile::Backend::Auto;
+
+utils::thread::ThreadPool& pool() {
+  static utils::thread::ThreadPool inst(kPoolSize);
+  return inst;
+}
+
+// 每个事件循环线程一个环，在准备阶段批量提交，完成时由eventfd唤醒收割。
+// 线程退出时等待环上未完成的请求，其回调在该线程中直接执行
+class Ring {
+ public:
+  Ring() : thd_(Thread::this_thread()), uring_(kRingEntries) {
+    if (!uring_.isValid()) {
+      return;
+    }
+    trigger_.emplace(thd_->addEvent(uring_.eventFd(), Events::ReadOnly,
+                                    [this](const Event*) { uring_.reap(); }));
+    hook_ = thd_->addHook(Thread::Phase::Prepare, [this]() { uring_.flush(); });
+  }
+
+  ~Ring() {
+    if (hook_ != -1) {
+      thd_->removeHook(hook_);
+    }
+    if (uring_.isValid()) {
+      uring_.drain();
+    }
+  }
+
+  Uring* get() { return uring_.isValid() ? &uring_ : nullptr; }
+
+  static Ring& instance() {
+    thread_local Ring inst;
+    return inst;
+  }
+
+ private:
+  Thread const* thd_;
+  Uring uring_;
+  std::optional<Trigger> trigger_;
+  int hook_ = -1;
+};
+
+}  // namespace
+
+AsyncFile::AsyncFile(Object* parent) : Object(parent) {}
+
+AsyncFile::~AsyncFile() {
+  close();
+}
+
+bool AsyncFile::open(const std::string& path, int flags, mode_t mode) {
+  close();
+  int fd = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+  if (fd == -1) {
+    return false;
+  }
+  handle_ = std::make_shared<Handle>(fd);
+  return true;
+}
+
+void AsyncFile::close() {
+  // 未完成的请求持有handle，fd在其全部完成后关闭
+  handle_.reset();
+}
+
+bool AsyncFile::isOpen() const {
+  return handle_ != nullptr;
+}
+
+int AsyncFile::fd() const {
+  return handle_ ? handle_->fd_ : -1;
+}
+
+void AsyncFile::read(void* buf,
+                     size_t size,
+                     off_t offset,
+                     const Callback& callback) {
+  submit(false, buf, size, offset, callback);
+}
+
+void AsyncFile::write(const void* buf,
+                      size_t size,
+                      off_t offset,
+                      const Callback& callback) {
+  submit(true, const_cast<void*>(buf), size, offset, callback);
+}
+
+void AsyncFile::setBackend(Backend backend) {
+  g_backend = backend;
+}
+
+AsyncFile::Backend AsyncFile::backend() {
+  auto backend = g_backend.load();
+  if (backend == Backend::Auto) {
+    backend = Uring::supported() ? Backend::Uring : Backend::ThreadPool;
+  }
+  return backend;
+}
+
+void AsyncFile::submit(bool write,
+                       void* buf,
+                       size_t size,
+                       off_t offset,
+                       const Callback& callback) {
+  auto thd = Thread::this_thread();
+  if (!handle_) {
+    thd->post([callback]() { callback(-EBADF); });
+    return;
+  }
+
+  // 环的提交与收割都在所属线程的事件循环中进行，没有事件循环的线程使用线程池
+  if (backend() == Backend::Uring && Thread::inEventLoop()) {
+    if (auto uring = Ring::instance().get(); uring) {
+      auto req = std::make_unique<Uring::Request>();
+      req->opcode_ = write ? IORING_OP_WRITE : IORING_OP_READ;
+      req->fd_ = handle_->fd_;
+      req->buf_ = buf;
+      req->size_ = size;
+      req->offset_ = offset;
+      req->callback_ = callback;
+      req->keep_ = handle_;
+      uring->push(std::move(req));
+      return;
+    }
+  }
+
+  pool().post([handle = handle_, write, buf, size, offset, callback, thd]() {
+    auto ret = write ? ::pwrite(handle->fd_, buf, size, offset)
+                     : ::pread(handle->fd_, buf, size, offset);
+    if (ret < 0) {
+      ret = -errno;
+    }
+    thd->post([callback, ret]() { callback(ret); });
+  });
+}
+
+}  // namespace core
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "core/object.h"
+
+namespace core {
+
+/**
+ * @brief
+ * 异步文件读写，读写在事件循环之外进行，事件循环的延迟不受磁盘延迟影响。
+ * 内核支持时使用io_uring，每个事件循环线程一个环；否则交给I/O线程池。
+ * 完成回调在发起调用的线程的事件循环中执行，没有运行事件循环的线程
+ * 总是使用线程池，回调在主线程的事件循环中执行。
+ * 线程退出时等待其io_uring上未完成的请求，回调在线程退出前执行。
+ * 缓冲区由调用方提供，须在回调执行前保持有效；
+ * 对象析构后fd在最后一个请求完成时才关闭，回调仍会执行。
+ */
+class AsyncFile : public Object {
+  META_OBJECT(AsyncFile, Object)
+
+ public:
+  // 参数为传输的字节数，失败时为负的errno
+  using Callback = std::function<void(ssize_t)>;
+
+  enum class Backend {
+    Auto,
+    Uring,
+    ThreadPool,
+  };
+
+  explicit AsyncFile(Object* parent = nullptr);
+  ~AsyncFile() override;
+
+  bool open(const std::string& path, int flags, mode_t mode = 0644);
+  void close();
+  bool isOpen() const;
+  int fd() const;
+
+  void read(void* buf, size_t size, off_t offset, const Callback& callback);
+  void write(const void* buf,
+             size_t size,
+             off_t offset,
+             const Callback& callback);
+
+  /**
+   * @brief
+   * 指定后端，须在首次读写之前调用。
+   * Auto在内核支持io_uring时使用io_uring
+   */
+  static void setBackend(Backend backend);
+  static Backend backend();
+
+ private:
+  void submit(bool write,
+              void* buf,
+              size_t size,
+              off_t offset,
+              const Callback& callback);
+
+  struct Handle;
+  std::shared_ptr<Handle> handle_;
+};
+
+}  // namespace core
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <atomic>
+#include <string>
+
+#include "core/file/async_file.h"
+#include "core/file/uring.h"
+#include "core/thread.h"
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 2000) {
+  for (int i = 0; i < timeout_ms; ++i) {
+    if (pred()) {
+      return true;
+    }
+    usleep(1000);
+  }
+  return pred();
+}
+
+// 在事件循环中写入后读回，回调须在发起线程中执行
+std::string tempFile() {
+  char path[] = "/tmp/async_file_XXXXXX";
+  int tmp = mkstemp(path);
+  if (tmp != -1) {
+    ::close(tmp);
+  }
+  return path;
+}
+
+void writeAndRead(core::AsyncFile::Backend backend) {
+  core::AsyncFile::setBackend(backend);
+
+  auto path = tempFile();
+
+  core::Thread a("a");
+  a.start();
+
+  const std::string data = "phoenix async file";
+  std::string out(data.size(), '\0');
+  std::atomic<ssize_t> written = 0;
+  std::atomic<ssize_t> read = 0;
+  std::atomic<bool> on_a = true;
+  core::AsyncFile file;
+
+  a.post([&]() {
+    ASSERT_TRUE(file.open(path, O_RDWR));
+    file.write(data.data(), data.size(), 0, [&](ssize_t ret) {
+      on_a = on_a && core::Thread::this_thread() == &a;
+      written = ret;
+      file.read(out.data(), out.size(), 0, [&](ssize_t ret) {
+        on_a = on_a && core::Thread::this_thread() == &a;
+        read = ret;
+      });
+    });
+  });
+
+  ASSERT_TRUE(waitFor([&]() { return read != 0; }));
+  EXPECT_EQ(written, static_cast<ssize_t>(data.size()));
+  EXPECT_EQ(read, static_cast<ssize_t>(data.size()));
+  EXPECT_EQ(out, data);
+  EXPECT_TRUE(on_a);
+
+  // 错误以负的errno返回
+  std::atomic<ssize_t> err = 0;
+  a.post([&]() {
+    file.close();
+    file.read(out.data(), out.size(), 0, [&](ssize_t ret) { err = ret; });
+  });
+  ASSERT_TRUE(waitFor([&]() { return err != 0; }));
+  EXPECT_EQ(err, -EBADF);
+
+  a.stop();
+  a.wait();
+  unlink(path.c_str());
+}
+
+}  // namespace
+
+TEST(AsyncFile, ThreadPool) {
+  writeAndRead(core::AsyncFile::Backend::ThreadPool);
+}
+
+TEST(AsyncFile, Auto) {
+  writeAndRead(core::AsyncFile::Backend::Auto);
+}
+
+TEST(AsyncFile, NonLoopCaller) {
+  core::AsyncFile::setBackend(core::AsyncFile::Backend::Auto);
+  auto path = tempFile();
+  core::AsyncFile file;
+  ASSERT_TRUE(file.open(path, O_RDWR));
+
+  // 没有运行事件循环的线程使用线程池，回调在主线程的事件循环中执行
+  std::atomic<ssize_t> written = 0;
+  std::atomic<core::Thread*> run_by = nullptr;
+  file.write("data", 4, 0, [&](ssize_t ret) {
+    run_by = core::Thread::this_thread();
+    written = ret;
+  });
+  ASSERT_TRUE(waitFor([&]() {
+    core::Application::thread()->processEvents(1);
+    return written != 0;
+  }));
+  EXPECT_EQ(written, 4);
+  EXPECT_EQ(run_by, core::Application::thread());
+  unlink(path.c_str());
+}
+
+TEST(AsyncFile, DrainOnExit) {
+  if (!core::Uring::supported()) {
+    GTEST_SKIP();
+  }
+  core::AsyncFile::setBackend(core::AsyncFile::Backend::Uring);
+  auto path = tempFile();
+  core::AsyncFile file;
+  ASSERT_TRUE(file.open(path, O_RDWR));
+
+  // 请求发出后事件循环立即退出，线程结束前所有回调仍会执行
+  constexpr int kCount = 64;
+  std::atomic<int> done = 0;
+  core::Thread a("a");
+  a.start();
+  a.post([&]() {
+    for (int i = 0; i < kCount; ++i) {
+      file.write("x", 1, i, [&](ssize_t ret) { done += ret == 1; });
+    }
+    a.stop();
+  });
+  ASSERT_TRUE(a.wait(2000));
+  a.join();
+  EXPECT_EQ(done, kCount);
+  unlink(path.c_str());
+}
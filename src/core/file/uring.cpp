@@ -0,0 +1,228 @@
+#include "core/file/uring.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "utils/macros.hpp"
+
+namespace core {
+
+static int io_uring_setup(unsigned entries, struct io_uring_params* p) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_register(int fd,
+                             unsigned opcode,
+                             void* arg,
+                             unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+bool Uring::supported() {
+  static const bool ret = []() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = io_uring_setup(2, &params);
+    if (fd < 0) {
+      return false;
+    }
+
+    // IORING_OP_READ/WRITE自5.6起支持，探测接口也是同一版本引入
+    std::vector<char> buf(sizeof(struct io_uring_probe) +
+                          256 * sizeof(struct io_uring_probe_op));
+    auto probe = reinterpret_cast<struct io_uring_probe*>(buf.data());
+    bool ok = io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+              probe->last_op >= IORING_OP_WRITE &&
+              (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+              (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+    ::close(fd);
+    return ok;
+  }();
+  return ret;
+}
+
+Uring::Uring(unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = io_uring_setup(entries, &params);
+  if (ring_fd_ < 0) {
+    ring_fd_ = -1;
+    return;
+  }
+
+  sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single) {
+    sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+  }
+
+  sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  cq_ptr_ = single ? sq_ptr_
+                   : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED ||
+      event_fd_ == -1 ||
+      io_uring_register(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) !=
+          0) {
+    sq_ptr_ = sq_ptr_ == MAP_FAILED ? nullptr : sq_ptr_;
+    cq_ptr_ = cq_ptr_ == MAP_FAILED ? nullptr : cq_ptr_;
+    sqes_ = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(sqes);
+    release();
+    return;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  auto sq = static_cast<char*>(sq_ptr_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  sq_entries_ = params.sq_entries;
+
+  auto cq = static_cast<char*>(cq_ptr_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  cq_entries_ = params.cq_entries;
+}
+
+Uring::~Uring() {
+  release();
+}
+
+void Uring::release() {
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+    munmap(cq_ptr_, cq_size_);
+  }
+  if (sq_ptr_) {
+    munmap(sq_ptr_, sq_size_);
+  }
+  if (ring_fd_ != -1) {
+    ::close(ring_fd_);
+  }
+  if (event_fd_ != -1) {
+    ::close(event_fd_);
+  }
+  sqes_ = nullptr;
+  sq_ptr_ = cq_ptr_ = nullptr;
+  ring_fd_ = event_fd_ = -1;
+}
+
+void Uring::push(std::unique_ptr<Request> req) {
+  if (!backlog_.empty() || !prepare(req)) {
+    backlog_.push_back(std::move(req));
+  }
+}
+
+bool Uring::prepare(std::unique_ptr<Request>& req) {
+  if (inflight_ + pending_ >= cq_entries_) {
+    return false;
+  }
+
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    flush();
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      return false;
+    }
+  }
+
+  unsigned index = tail & *sq_mask_;
+  auto sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = req->opcode_;
+  sqe->fd = req->fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(req->buf_);
+  sqe->len = static_cast<uint32_t>(req->size_);
+  sqe->off = static_cast<uint64_t>(req->offset_);
+  sqe->user_data = reinterpret_cast<uint64_t>(req.release());
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++pending_;
+  return true;
+}
+
+int Uring::enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+void Uring::flush() {
+  while (pending_ != 0) {
+    int ret = enter(pending_, 0, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // EAGAIN/EBUSY：内核暂时无法接收，等下一次完成后再提交
+      return;
+    }
+    pending_ -= static_cast<unsigned>(ret);
+    inflight_ += static_cast<unsigned>(ret);
+  }
+}
+
+std::size_t Uring::reap() {
+  uint64_t count;
+  auto size = ::read(event_fd_, &count, sizeof(count));
+  UNUSED(size);
+
+  std::size_t n = 0;
+  for (;;) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+
+    auto cqe = &cqes_[head & *cq_mask_];
+    std::unique_ptr<Request> req(reinterpret_cast<Request*>(cqe->user_data));
+    ssize_t res = cqe->res;
+    // 先归还完成队列的位置，回调中可能继续提交
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    --inflight_;
+    ++n;
+
+    if (req->callback_) {
+      req->callback_(res);
+    }
+  }
+
+  while (!backlog_.empty() && prepare(backlog_.front())) {
+    backlog_.pop_front();
+  }
+  flush();
+  return n;
+}
+
+void Uring::drain() {
+  flush();
+  while (isBusy()) {
+    if (inflight_ != 0 && enter(0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      return;
+    }
+    reap();
+  }
+}
+
+}  // namespace core
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace core {
+
+/**
+ * @brief
+ * 直接基于io_uring系统调用的提交/完成队列，不依赖liburing。
+ * 提交与收割须在同一线程中进行，完成时通过eventfd通知
+ */
+class Uring {
+ public:
+  using Callback = std::function<void(ssize_t)>;
+
+  struct Request {
+    uint8_t opcode_;
+    int fd_;
+    void* buf_;
+    size_t size_;
+    off_t offset_;
+    Callback callback_;
+    // 保证请求完成前fd不被关闭
+    std::shared_ptr<void> keep_;
+  };
+
+  // 内核是否支持io_uring(可能被seccomp等禁止)
+  static bool supported();
+
+  explicit Uring(unsigned entries = 256);
+  ~Uring();
+
+  Uring(const Uring&) = delete;
+  Uring& operator=(const Uring&) = delete;
+
+  bool isValid() const { return ring_fd_ != -1; }
+  // 完成队列非空时可读
+  int eventFd() const { return event_fd_; }
+
+  // 放入提交队列，由flush统一提交
+  void push(std::unique_ptr<Request> req);
+  void flush();
+  // 处理完成队列中的请求，返回处理的个数
+  std::size_t reap();
+  // 阻塞直到所有请求完成，回调在调用线程中执行
+  void drain();
+
+  // 是否有未完成的请求
+  bool isBusy() const {
+    return pending_ + inflight_ != 0 || !backlog_.empty();
+  }
+
+ private:
+  bool prepare(std::unique_ptr<Request>& req);
+  void release();
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+
+  int ring_fd_ = -1;
+  int event_fd_ = -1;
+
+  void* sq_ptr_ = nullptr;
+  size_t sq_size_ = 0;
+  void* cq_ptr_ = nullptr;
+  size_t cq_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_entries_ = 0;
+
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned cq_entries_ = 0;
+
+  // 已放入提交队列但尚未提交的个数
+  unsigned pending_ = 0;
+  // 已提交尚未完成的个数，不超过完成队列的容量
+  unsigned inflight_ = 0;
+  // 完成队列容量不足时暂存的请求
+  std::deque<std::unique_ptr<Request>> backlog_;
+};
+
+}  // namespace core
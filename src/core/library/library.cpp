@@ -1,12 +1,14 @@
 #include "core/library/library.h"
 
 #include <dlfcn.h>
-#include <error.h>
-#include <string.h>
+
+#include <algorithm>
+#include <mutex>
 
 namespace core {
 
-Library::Library(const std::string& path) : path_(path) {
+Library::Library(const std::string& path, Binding binding)
+    : path_(path), binding_(binding) {
   load();
 }
 
@@ -24,6 +26,10 @@ void Library::setLibPath(const std::string& name) {
   path_ = name;
 }
 
+void Library::setBinding(Binding binding) {
+  binding_ = binding;
+}
+
 bool Library::isLoaded() const {
   return handler_ != nullptr;
 }
@@ -33,34 +39,84 @@ void Library::load() {
     return;
   }
 
-  handler_ = dlopen(path_.c_str(), RTLD_LOCAL | RTLD_LAZY);
+  auto mode = binding_ == Binding::Now ? RTLD_NOW : RTLD_LAZY;
+  handler_ = dlopen(path_.c_str(), RTLD_LOCAL | mode);
   if (!handler_) {
-    error_ = strerror(errno);
+    setError(dlerror());
+    return;
   }
+  resolveDeclared();
+  generation_.fetch_add(1, std::memory_order_release);
 }
 
 void Library::unload() {
   if (isLoaded()) {
     dlclose(handler_);
+    handler_ = nullptr;
   }
+
+  {
+    std::unique_lock lck(mtx_);
+    symbols_.clear();
+  }
+  generation_.fetch_add(1, std::memory_order_release);
 }
 
-void* Library::resolve(const std::string& name) {
+void* Library::resolve(std::string_view name) {
   if (!isLoaded()) {
-    error_ = "Please load the library first";
+    setError("Please load the library first");
     return nullptr;
   }
 
-  void* ret = dlsym(handler_, name.c_str());
-  if (!ret) {
-    error_ = strerror(errno);
+  auto less = [](const std::pair<std::string, void*>& l, std::string_view r) {
+    return l.first < r;
+  };
+  {
+    std::shared_lock lck(mtx_);
+    auto iter = std::lower_bound(symbols_.begin(), symbols_.end(), name, less);
+    if (iter != symbols_.end() && iter->first == name) {
+      return iter->second;
+    }
   }
 
+  std::string symbol(name);
+  // dlsym返回空也可能是合法的符号值，以dlerror区分
+  dlerror();
+  void* ret = dlsym(handler_, symbol.c_str());
+  auto err = dlerror();
+
+  std::unique_lock lck(mtx_);
+  if (err) {
+    error_ = err;
+  }
+  auto iter = std::lower_bound(symbols_.begin(), symbols_.end(), name, less);
+  if (iter == symbols_.end() || iter->first != name) {
+    symbols_.emplace(iter, std::move(symbol), ret);
+  }
+  return ret;
+}
+
+bool Library::declare(const std::vector<std::string>& names) {
+  declared_.insert(declared_.end(), names.begin(), names.end());
+  return isLoaded() && resolveDeclared();
+}
+
+bool Library::resolveDeclared() {
+  bool ret = true;
+  for (auto const& name : declared_) {
+    ret = resolve(name) != nullptr && ret;
+  }
   return ret;
 }
 
 std::string Library::error() const {
+  std::shared_lock lck(mtx_);
   return error_;
 }
 
-}  // namespace core
\ No newline at end of file
+void Library::setError(std::string error) {
+  std::unique_lock lck(mtx_);
+  error_ = std::move(error);
+}
+
+}  // namespace core
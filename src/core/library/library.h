@@ -1,30 +1,137 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "core/object.h"
 
 namespace core {
 
+/**
+ * @brief
+ * 动态库的加载与符号解析。
+ * 符号解析结果按名字缓存在有序的扁平表中，每个符号只调用一次dlsym，
+ * 卸载或更换路径时清空。热路径上应保存declare<Sig>返回的Symbol句柄，
+ * 调用时不加锁也不查表
+ *
+ * e.g.
+ * core::Library lib("libplugin.so", core::Library::Binding::Now);
+ * auto create = lib.declare<Plugin*(const char*)>("create_plugin");
+ * auto plugin = create("name");
+ */
 class Library final : public Object {
+  META_OBJECT(Library, Object)
+
  public:
-  explicit Library(const std::string& path);
+  enum class Binding {
+    Lazy,  // RTLD_LAZY，函数在首次调用时才绑定
+    Now,   // RTLD_NOW，加载时绑定全部符号，首次调用没有额外延迟
+  };
+
+  /**
+   * @brief
+   * 缓存函数指针的符号句柄。每次调用只比较一次库的加载代数，
+   * 库重新加载或卸载后在下次调用时重新解析。
+   * 句柄不得比Library存活更久，各线程应持有各自的副本
+   */
+  template <typename Sig>
+  class Symbol {
+    static_assert(std::is_function_v<Sig>, "Sig must be a function type");
+
+   public:
+    Symbol() = default;
+
+    Sig* get() const {
+      if (!lib_) {
+        return nullptr;
+      }
+      auto generation = lib_->generation_.load(std::memory_order_acquire);
+      if (generation != generation_) {
+        fn_ = lib_->resolve<Sig>(name_);
+        generation_ = generation;
+      }
+      return fn_;
+    }
+    explicit operator bool() const { return get() != nullptr; }
+
+    template <typename... Args>
+    decltype(auto) operator()(Args&&... args) const {
+      return get()(std::forward<Args>(args)...);
+    }
+
+   private:
+    Symbol(Library* lib, std::string name)
+        : lib_(lib), name_(std::move(name)) {}
+
+    Library* lib_ = nullptr;
+    std::string name_;
+    mutable Sig* fn_ = nullptr;
+    // 库的代数从1开始，0表示尚未解析
+    mutable uint64_t generation_ = 0;
+
+    friend class Library;
+  };
+
+  explicit Library(const std::string& path, Binding binding = Binding::Lazy);
   ~Library() override;
 
   void setLibPath(const std::string& path);
+  // 在下次加载时生效
+  void setBinding(Binding binding);
 
   bool isLoaded() const;
 
   void load();
   void unload();
 
-  void* resolve(const std::string& name);
+  void* resolve(std::string_view name);
+
+  template <typename Sig>
+  Sig* resolve(std::string_view name) {
+    static_assert(std::is_function_v<Sig>, "Sig must be a function type");
+    return reinterpret_cast<Sig*>(resolve(name));
+  }
+
+  /**
+   * @brief
+   * 声明需要的符号，已加载时立即解析，否则在加载时解析
+   * @return 已加载且全部解析成功时返回true
+   */
+  bool declare(const std::vector<std::string>& names);
+
+  // 声明单个符号并返回其句柄，已加载时立即解析
+  template <typename Sig>
+  Symbol<Sig> declare(std::string name) {
+    declared_.push_back(name);
+    Symbol<Sig> ret(this, std::move(name));
+    ret.get();
+    return ret;
+  }
 
   std::string error() const;
 
  private:
+  bool resolveDeclared();
+  void setError(std::string error);
+
   std::string path_;
-  void* handler_;
+  Binding binding_;
+  void* handler_ = nullptr;
+  // 每次加载或卸载后递增，Symbol据此判断缓存是否失效
+  std::atomic<uint64_t> generation_ = 1;
+
+  // 保护symbols_与error_，symbols_按名字排序，未找到的符号同样缓存
+  mutable std::shared_mutex mtx_;
+  std::vector<std::pair<std::string, void*>> symbols_;
+  std::vector<std::string> declared_;
 
   std::string error_;
 };
 
-}  // namespace core
\ No newline at end of file
+}  // namespace core
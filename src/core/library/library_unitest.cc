@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/library/library.h"
+
+TEST(Library, Resolve) {
+  core::Library lib("libm.so.6", core::Library::Binding::Now);
+  ASSERT_TRUE(lib.isLoaded()) << lib.error();
+
+  auto cos = lib.resolve<double(double)>("cos");
+  ASSERT_NE(cos, nullptr);
+  EXPECT_DOUBLE_EQ(cos(0.0), 1.0);
+  // 再次解析命中缓存
+  EXPECT_EQ(lib.resolve<double(double)>("cos"), cos);
+  EXPECT_EQ(lib.resolve("cos"), reinterpret_cast<void*>(cos));
+
+  EXPECT_EQ(lib.resolve("no_such_symbol"), nullptr);
+  EXPECT_FALSE(lib.error().empty());
+
+  EXPECT_TRUE(lib.declare({"sin", "sqrt"}));
+  EXPECT_FALSE(lib.declare({"no_such_symbol"}));
+
+  lib.unload();
+  EXPECT_FALSE(lib.isLoaded());
+  EXPECT_EQ(lib.resolve("cos"), nullptr);
+
+  lib.setBinding(core::Library::Binding::Lazy);
+  lib.load();
+  EXPECT_EQ(lib.resolve<double(double)>("sqrt")(4.0), 2.0);
+}
+
+TEST(Library, Symbol) {
+  core::Library lib("libm.so.6");
+  ASSERT_TRUE(lib.isLoaded()) << lib.error();
+
+  auto cos = lib.declare<double(double)>("cos");
+  ASSERT_TRUE(cos);
+  EXPECT_DOUBLE_EQ(cos(0.0), 1.0);
+  EXPECT_EQ(cos.get(), lib.resolve<double(double)>("cos"));
+  EXPECT_FALSE(lib.declare<double(double)>("no_such_symbol"));
+  EXPECT_FALSE(core::Library::Symbol<double(double)>());
+
+  // 卸载后句柄失效，重新加载后再次解析
+  lib.unload();
+  EXPECT_FALSE(cos);
+  lib.load();
+  ASSERT_TRUE(cos);
+  EXPECT_DOUBLE_EQ(cos(0.0), 1.0);
+
+  // 加载前声明的句柄在加载后可用
+  core::Library later("libno_such_library.so");
+  auto sqrt = later.declare<double(double)>("sqrt");
+  EXPECT_FALSE(sqrt);
+  later.setLibPath("libm.so.6");
+  later.load();
+  EXPECT_EQ(sqrt(4.0), 2.0);
+}
+
+TEST(Library, LoadFailed) {
+  core::Library lib("libno_such_library.so");
+  EXPECT_FALSE(lib.isLoaded());
+  EXPECT_FALSE(lib.error().empty());
+  EXPECT_EQ(lib.resolve("cos"), nullptr);
+}
+
+TEST(Library, ConcurrentResolve) {
+  core::Library lib("libm.so.6");
+  ASSERT_TRUE(lib.isLoaded()) << lib.error();
+
+  // 多个线程同时解析并读取错误信息
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&lib, t]() {
+      for (int i = 0; i < 100; ++i) {
+        lib.resolve("missing_" + std::to_string(t * 100 + i));
+        EXPECT_FALSE(lib.error().empty());
+      }
+    });
+  }
+  for (auto& thd : threads) {
+    thd.join();
+  }
+  EXPECT_NE(lib.resolve("cos"), nullptr);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief
+ * core::Object派生类的编译期类型信息。
+ * 在类定义中使用META_OBJECT(类名, 直接基类)声明后：
+ *   - T::staticMetaType().id 为类名的编译期哈希
+ *   - T::staticMetaType().name 为静态存储的类名，不分配内存
+ *   - object_cast<T>通过祖先表在O(1)内按id判断继承关系，不依赖dynamic_cast，
+ *     也不依赖类型信息在各动态库间地址唯一
+ * 仅支持单继承链，未声明的派生类沿用最近的已声明祖先的类型信息。
+ *
+ * e.g.
+ * class Connection : public core::Object {
+ *   META_OBJECT(Connection, core::Object)
+ * };
+ */
+
+namespace core {
+
+class Object;
+
+struct MetaType {
+  std::string_view name;
+  uint64_t id;
+  // 到core::Object的继承深度，Object为0
+  std::size_t depth;
+  // ancestry[i]为深度i的祖先，ancestry[depth]为自身
+  const MetaType* const* ancestry;
+
+  // 以RTLD_LOCAL加载或未使用GNU unique符号的动态库各有一份类型信息，
+  // 地址不同时以id判断
+  bool inherits(const MetaType& base) const {
+    if (base.depth > depth) {
+      return false;
+    }
+    auto ancestor = ancestry[base.depth];
+    return ancestor == &base || ancestor->id == base.id;
+  }
+};
+
+namespace detail {
+
+template <typename T>
+constexpr std::string_view type_name() {
+  // GCC: "... [with T = core::Timer; std::string_view = ...]"
+  // Clang: "... [T = core::Timer]"
+  constexpr std::string_view func = __PRETTY_FUNCTION__;
+  constexpr auto begin = func.find("T = ") + 4;
+  constexpr auto end = func.find_first_of(";]", begin);
+  return func.substr(begin, end - begin);
+}
+
+constexpr uint64_t fnv1a(std::string_view str) {
+  uint64_t hash = 14695981039346656037ull;
+  for (auto c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T>
+constexpr std::size_t meta_depth() {
+  if constexpr (std::is_same_v<T, Object>) {
+    return 0;
+  } else {
+    return meta_depth<typename T::SuperType>() + 1;
+  }
+}
+
+template <typename T>
+struct MetaTypeOf {
+  static const std::array<const MetaType*, meta_depth<T>() + 1> ancestry;
+  static const MetaType value;
+};
+
+template <typename T, std::size_t N>
+constexpr void fill_ancestry(std::array<const MetaType*, N>& arr) {
+  arr[meta_depth<T>()] = &MetaTypeOf<T>::value;
+  if constexpr (!std::is_same_v<T, Object>) {
+    fill_ancestry<typename T::SuperType>(arr);
+  }
+}
+
+template <typename T>
+constexpr std::array<const MetaType*, meta_depth<T>() + 1> make_ancestry() {
+  std::array<const MetaType*, meta_depth<T>() + 1> arr{};
+  fill_ancestry<T>(arr);
+  return arr;
+}
+
+// 初始化式均为常量表达式，在静态初始化阶段完成，不存在初始化顺序问题
+template <typename T>
+const std::array<const MetaType*, meta_depth<T>() + 1>
+    MetaTypeOf<T>::ancestry = make_ancestry<T>();
+
+template <typename T>
+const MetaType MetaTypeOf<T>::value = {type_name<T>(),
+                                       fnv1a(type_name<T>()), meta_depth<T>(),
+                                       MetaTypeOf<T>::ancestry.data()};
+
+}  // namespace detail
+
+template <typename T>
+constexpr bool has_meta_type_v = std::is_same_v<typename T::ThisType, T>;
+
+}  // namespace core
+
+#define META_OBJECT(cls, base)                                           \
+ public:                                                                 \
+  using ThisType = cls;                                                  \
+  using SuperType = base;                                                \
+  static const core::MetaType& staticMetaType() {                        \
+    static_assert(std::is_base_of_v<base, cls>, "Invalid Inheritance");  \
+    return core::detail::MetaTypeOf<cls>::value;                         \
+  }                                                                      \
+  const core::MetaType& metaType() const override {                      \
+    return staticMetaType();                                             \
+  }                                                                      \
+                                                                         \
+ private:
@@ -0,0 +1,84 @@
+#include <sys/resource.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "core/thread.h"
+
+// 迁移耗时测试：./core.migrate_test [fd数量，默认10000]
+// 计时区间从发起迁移开始，到全部fd完成一次触发为止，
+// 迁移请求被源线程处理前到达的触发仍在源线程上派发
+
+static int64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void waitFor(const std::atomic<int>& a,
+                    const std::atomic<int>& b,
+                    int expect) {
+  while (a + b < expect) {
+    usleep(100);
+  }
+}
+
+int main(int argc, char** argv) {
+  int size = argc > 1 ? atoi(argv[1]) : 10000;
+
+  struct rlimit lim;
+  getrlimit(RLIMIT_NOFILE, &lim);
+  lim.rlim_cur = lim.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &lim);
+
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+
+  std::atomic<int> on_a = 0;
+  std::atomic<int> on_b = 0;
+  std::vector<core::Trigger> triggers;
+  std::vector<int> fds;
+  triggers.reserve(size);
+  fds.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    triggers.emplace_back(
+        a.addEvent(core::Events::Execute, [&](const core::Event*) {
+          ++(core::Thread::this_thread() == &a ? on_a : on_b);
+        }));
+    fds.push_back(triggers.back().fd());
+  }
+  for (auto& t : triggers) {
+    t.trigger();
+  }
+  waitFor(on_a, on_b, size);
+
+  // 批量迁移：一次投递
+  auto start = now_us();
+  a.moveEvents(fds, &b);
+  for (auto& t : triggers) {
+    t.trigger();
+  }
+  waitFor(on_a, on_b, size * 2);
+  auto cost = now_us() - start;
+  std::cout << "batch moveEvents " << size << " fds: " << cost << " us, "
+            << static_cast<double>(cost) / size << " us/fd" << std::endl;
+
+  // 逐个迁移：每个fd一次投递
+  start = now_us();
+  for (auto& t : triggers) {
+    t.moveToThread(&a);
+  }
+  for (auto& t : triggers) {
+    t.trigger();
+  }
+  waitFor(on_a, on_b, size * 3);
+  cost = now_us() - start;
+  std::cout << "Trigger::moveToThread " << size << " fds: " << cost << " us, "
+            << static_cast<double>(cost) / size << " us/fd" << std::endl;
+
+  return 0;
+}
@@ -1,5 +1,10 @@
 #include "core/object.h"
 
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+
+#include "core/signal.h"
 #include "core/thread.h"
 
 namespace core {
@@ -9,38 +14,131 @@ Object::Object(Object* parent) : parent_(nullptr), thd_(Thread::this_thread()) {
 }
 
 Object::~Object() {
+  {
+    std::scoped_lock lck(slot_mtx_);
+    for (auto& weak : slots_) {
+      if (auto slot = weak.lock()) {
+        slot->connected_ = false;
+      }
+    }
+  }
+
   if (parent_) {
     parent_->removeChild(this);
   }
+  // 子对象的生命周期不由父对象管理，仅断开关系
+  for (auto child = first_child_; child;) {
+    auto next = child->next_sibling_;
+    child->parent_ = nullptr;
+    child->prev_sibling_ = child->next_sibling_ = nullptr;
+    child = next;
+  }
+}
+
+const std::string& Object::type() {
+  static std::shared_mutex mtx;
+  static std::unordered_map<std::type_index, std::string> names;
+
+  std::type_index index(type_info());
+  {
+    std::shared_lock lck(mtx);
+    if (auto iter = names.find(index); iter != names.end()) {
+      return iter->second;
+    }
+  }
+
+  std::unique_lock lck(mtx);
+  auto [iter, _] =
+      names.emplace(index, type_traits::demangle(type_info().name()));
+  return iter->second;
+}
+
+void Object::track(const std::shared_ptr<detail::SlotBase>& slot) {
+  std::scoped_lock lck(slot_mtx_);
+  slot->thd_ = thd_;
+  // 容量用尽时先清理已断开的连接，均摊O(1)
+  if (slots_.size() == slots_.capacity()) {
+    slots_.erase(std::remove_if(slots_.begin(), slots_.end(),
+                                [](const std::weak_ptr<detail::SlotBase>& s) {
+                                  return s.expired();
+                                }),
+                 slots_.end());
+  }
+  slots_.push_back(slot);
 }
 
 void Object::setParent(Object* parent) {
+  if (parent == parent_) {
+    return;
+  }
+
   if (parent_) {
     parent_->removeChild(this);
-    parent_->addChild(this);
   }
-
-  parent_ = parent;
+  if (parent) {
+    parent->addChild(this);
+  }
 }
 
 void Object::moveToThread(Thread* thd) {
-  for (auto& child : children_) {
+  for (auto child = first_child_; child; child = child->next_sibling_) {
     child->moveToThread(thd);
   }
   thd_ = thd;
+
+  std::scoped_lock lck(slot_mtx_);
+  for (auto& weak : slots_) {
+    if (auto slot = weak.lock()) {
+      slot->thd_ = thd;
+    }
+  }
+}
+
+void Object::deleteLater() {
+  if (delete_later_.exchange(true)) {
+    return;
+  }
+  thd_->deleteLater(this);
 }
 
 void Object::addChild(Object* child) {
-  if (std::find(children_.begin(), children_.end(), child) == children_.end()) {
-    children_.emplace_back(child);
+  if (child->parent_ == this) {
+    return;
   }
+  if (child->parent_) {
+    child->parent_->removeChild(child);
+  }
+
+  child->parent_ = this;
+  child->prev_sibling_ = last_child_;
+  child->next_sibling_ = nullptr;
+  if (last_child_) {
+    last_child_->next_sibling_ = child;
+  } else {
+    first_child_ = child;
+  }
+  last_child_ = child;
+  ++child_count_;
 }
 
 void Object::removeChild(Object* child) {
-  if (auto iter = std::find(children_.begin(), children_.end(), child);
-      iter != children_.end()) {
-    children_.erase(iter);
+  if (child->parent_ != this) {
+    return;
+  }
+
+  if (child->prev_sibling_) {
+    child->prev_sibling_->next_sibling_ = child->next_sibling_;
+  } else {
+    first_child_ = child->next_sibling_;
+  }
+  if (child->next_sibling_) {
+    child->next_sibling_->prev_sibling_ = child->prev_sibling_;
+  } else {
+    last_child_ = child->prev_sibling_;
   }
+  child->parent_ = nullptr;
+  child->prev_sibling_ = child->next_sibling_ = nullptr;
+  --child_count_;
 }
 
 }  // namespace core
\ No newline at end of file
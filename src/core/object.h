@@ -1,10 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 #include "core/event.h"
+#include "core/meta_type.h"
 #include "utils/type_traits.hpp"
 
 namespace thread {
@@ -13,10 +17,24 @@ class Thread;
 
 namespace core {
 
+namespace detail {
+struct SlotBase;
+}
+
+template <typename... Args>
+class Signal;
+
 class Object : public std::enable_shared_from_this<Object> {
  public:
   using Ptr = std::shared_ptr<Object>;
   using WPtr = std::weak_ptr<Object>;
+  using ThisType = Object;
+
+  static const MetaType& staticMetaType() {
+    return detail::MetaTypeOf<Object>::value;
+  }
+  // 最近的以META_OBJECT声明的类型
+  virtual const MetaType& metaType() const { return staticMetaType(); }
 
   explicit Object(Object* parent = nullptr);
   virtual ~Object();
@@ -37,23 +55,78 @@ class Object : public std::enable_shared_from_this<Object> {
     return *type;
   }
 
-  std::string type() { return type_traits::demangle(type_info().name()); }
+  // 动态类型的类名，每个类型只解析一次
+  const std::string& type();
 
   Thread const* thread() const { return thd_; }
 
+  Object* parent() const { return parent_; }
   void setParent(Object*);
 
+  // 子对象按加入顺序以兄弟指针串联，增删均为O(1)
+  Object* firstChild() const { return first_child_; }
+  Object* nextSibling() const { return next_sibling_; }
+  std::size_t childCount() const { return child_count_; }
+
   virtual void moveToThread(Thread*);
 
+  /**
+   * @brief
+   * 在所属线程当前一轮事件循环结束后析构，可在任意线程调用，重复调用只生效一次。
+   * 用于在自身的事件处理函数中销毁对象。
+   * 由shared_ptr持有的对象不会被直接delete，事件循环只持有其引用到该时刻为止
+   */
+  void deleteLater();
+
  protected:
   void addChild(Object*);
   void removeChild(Object*);
 
+  template <typename... Args>
+  friend class Signal;
+  // 记录以本对象为接收者的连接，迁移时更新其线程，析构时使其失效
+  void track(const std::shared_ptr<detail::SlotBase>& slot);
+
  private:
   Object* parent_;
-  std::list<Object*> children_;
+  // 侵入式的子对象链表
+  Object* first_child_ = nullptr;
+  Object* last_child_ = nullptr;
+  Object* prev_sibling_ = nullptr;
+  Object* next_sibling_ = nullptr;
+  std::size_t child_count_ = 0;
+
+  std::mutex slot_mtx_;
+  std::vector<std::weak_ptr<detail::SlotBase>> slots_;
 
   Thread const* thd_;
+  std::atomic<bool> delete_later_ = false;
 };
 
+/**
+ * @brief
+ * 基于META_OBJECT类型信息的向下转换，obj的动态类型不是T或其派生类时返回空
+ */
+template <typename T, typename U>
+T* object_cast(U* obj) {
+  static_assert(has_meta_type_v<T>, "T must be declared with META_OBJECT");
+  return obj && obj->metaType().inherits(T::staticMetaType())
+             ? static_cast<T*>(obj)
+             : nullptr;
+}
+
+template <typename T, typename U>
+const T* object_cast(const U* obj) {
+  static_assert(has_meta_type_v<T>, "T must be declared with META_OBJECT");
+  return obj && obj->metaType().inherits(T::staticMetaType())
+             ? static_cast<const T*>(obj)
+             : nullptr;
+}
+
+template <typename T, typename U>
+std::shared_ptr<T> object_cast(const std::shared_ptr<U>& obj) {
+  return object_cast<T>(obj.get()) ? std::static_pointer_cast<T>(obj)
+                                   : nullptr;
+}
+
 }  // namespace core
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/object.h"
+
+// 类型判断耗时测试：./core.object_cast_test [次数，默认10000000]
+// 对比object_cast、dynamic_cast/dynamic_pointer_cast与类名字符串比较
+
+class Message : public core::Object {
+  META_OBJECT(Message, core::Object)
+};
+
+class Request : public Message {
+  META_OBJECT(Request, Message)
+};
+
+class HttpRequest : public Request {
+  META_OBJECT(HttpRequest, Request)
+};
+
+class Response : public Message {
+  META_OBJECT(Response, Message)
+};
+
+static int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+template <typename F>
+static void bench(const char* name, int count, F&& f) {
+  std::size_t hits = 0;
+  auto start = now_ns();
+  for (int i = 0; i < count; ++i) {
+    hits += f(i);
+  }
+  auto cost = now_ns() - start;
+  std::cout << name << ": " << static_cast<double>(cost) / count
+            << " ns/op (hits " << hits << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 10000000;
+
+  std::vector<std::shared_ptr<core::Object>> objs = {
+      std::make_shared<HttpRequest>(), std::make_shared<Response>(),
+      std::make_shared<Request>(), std::make_shared<Message>()};
+  auto size = objs.size();
+
+  bench("object_cast<Request>(raw)", count, [&](int i) {
+    return core::object_cast<Request>(objs[i % size].get()) != nullptr;
+  });
+  bench("dynamic_cast<Request*>", count, [&](int i) {
+    return dynamic_cast<Request*>(objs[i % size].get()) != nullptr;
+  });
+  bench("object_cast<Request>(shared_ptr)", count, [&](int i) {
+    return core::object_cast<Request>(objs[i % size]) != nullptr;
+  });
+  bench("dynamic_pointer_cast<Request>", count, [&](int i) {
+    return std::dynamic_pointer_cast<Request>(objs[i % size]) != nullptr;
+  });
+  bench("metaType().id == HttpRequest", count, [&](int i) {
+    return objs[i % size]->metaType().id == HttpRequest::staticMetaType().id;
+  });
+  const std::string name = "HttpRequest";
+  bench("type() == \"HttpRequest\" (interned)", count,
+        [&](int i) { return objs[i % size]->type() == name; });
+  bench("demangle == \"HttpRequest\" (per call)", count, [&](int i) {
+    return type_traits::demangle(objs[i % size]->type_info().name()) == name;
+  });
+
+  return 0;
+}
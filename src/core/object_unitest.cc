@@ -3,11 +3,118 @@
 #include "core/object.h"
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 struct MainObject : public core::Object {};
 
+class Connection : public core::Object {
+  META_OBJECT(Connection, core::Object)
+};
+
+class TcpConnection : public Connection {
+  META_OBJECT(TcpConnection, Connection)
+};
+
+class Listener : public core::Object {
+  META_OBJECT(Listener, core::Object)
+};
+
+// 未声明META_OBJECT的派生类沿用TcpConnection的类型信息
+class TlsConnection : public TcpConnection {};
+
 TEST(Object, Type) {
   std::string type = std::make_shared<core::Object>()->type();
   EXPECT_EQ(type, "core::Object");
   EXPECT_EQ(std::make_shared<MainObject>()->type(), "MainObject");
-}
\ No newline at end of file
+}
+TEST(Object, Parent) {
+  core::Object a;
+  core::Object b;
+  core::Object c(&a);
+  core::Object d(&a);
+  EXPECT_EQ(c.parent(), &a);
+  EXPECT_EQ(a.childCount(), 2u);
+  EXPECT_EQ(a.firstChild(), &c);
+  EXPECT_EQ(c.nextSibling(), &d);
+
+  // 重新设置父对象后从原父对象中移除
+  c.setParent(&b);
+  EXPECT_EQ(c.parent(), &b);
+  EXPECT_EQ(a.childCount(), 1u);
+  EXPECT_EQ(a.firstChild(), &d);
+  EXPECT_EQ(b.firstChild(), &c);
+
+  c.setParent(nullptr);
+  EXPECT_EQ(c.parent(), nullptr);
+  EXPECT_EQ(b.childCount(), 0u);
+  EXPECT_EQ(b.firstChild(), nullptr);
+
+  {
+    core::Object e(&a);
+    EXPECT_EQ(a.childCount(), 2u);
+  }
+  EXPECT_EQ(a.childCount(), 1u);
+  EXPECT_EQ(d.nextSibling(), nullptr);
+}
+
+TEST(Object, ManyChildren) {
+  constexpr int size = 100000;
+  core::Object parent;
+  std::vector<std::unique_ptr<core::Object>> children;
+  children.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    children.emplace_back(std::make_unique<core::Object>(&parent));
+  }
+  EXPECT_EQ(parent.childCount(), static_cast<std::size_t>(size));
+
+  // 重新挂载与销毁均为O(1)
+  core::Object other;
+  for (int i = 0; i < size; i += 2) {
+    children[i]->setParent(&other);
+  }
+  EXPECT_EQ(other.childCount(), static_cast<std::size_t>(size / 2));
+  children.clear();
+  EXPECT_EQ(parent.childCount(), 0u);
+  EXPECT_EQ(other.childCount(), 0u);
+}
+
+TEST(Object, MetaType) {
+  // 类名与id在编译期确定
+  static_assert(core::detail::type_name<TcpConnection>() == "TcpConnection");
+  constexpr auto id = core::detail::fnv1a("TcpConnection");
+  EXPECT_EQ(TcpConnection::staticMetaType().id, id);
+  EXPECT_EQ(TcpConnection::staticMetaType().name, "TcpConnection");
+  EXPECT_EQ(core::Object::staticMetaType().name, "core::Object");
+  EXPECT_EQ(TcpConnection::staticMetaType().depth, 2u);
+
+  TlsConnection tls;
+  core::Object* obj = &tls;
+  EXPECT_EQ(&obj->metaType(), &TcpConnection::staticMetaType());
+  EXPECT_EQ(core::object_cast<Connection>(obj), &tls);
+  EXPECT_EQ(core::object_cast<TcpConnection>(obj), &tls);
+
+  Connection conn;
+  obj = &conn;
+  EXPECT_EQ(core::object_cast<Connection>(obj), &conn);
+  EXPECT_EQ(core::object_cast<TcpConnection>(obj), nullptr);
+  EXPECT_EQ(core::object_cast<Connection>(static_cast<core::Object*>(nullptr)),
+            nullptr);
+
+  std::shared_ptr<core::Object> ptr = std::make_shared<TcpConnection>();
+  EXPECT_NE(core::object_cast<Connection>(ptr), nullptr);
+  ptr = std::make_shared<MainObject>();
+  EXPECT_EQ(core::object_cast<TcpConnection>(ptr), nullptr);
+
+  // 其他动态库中的类型信息副本地址不同，按id判断
+  auto copy = Connection::staticMetaType();
+  EXPECT_NE(&copy, &Connection::staticMetaType());
+  EXPECT_TRUE(TcpConnection::staticMetaType().inherits(copy));
+  EXPECT_TRUE(Connection::staticMetaType().inherits(copy));
+  auto other = Listener::staticMetaType();
+  EXPECT_FALSE(TcpConnection::staticMetaType().inherits(other));
+
+  // 类名只解析一次
+  EXPECT_EQ(&tls.type(), &tls.type());
+  EXPECT_EQ(tls.type(), "TlsConnection");
+}
@@ -0,0 +1,30 @@
+#include "core/poller.h"
+
+#include <atomic>
+
+#include "core/poller/epoller.h"
+#include "core/poller/virtual_poller.h"
+
+namespace core {
+
+static std::atomic<PollerType> g_poller_type = PollerType::Epoll;
+
+void setPollerType(PollerType type) {
+  g_poller_type = type;
+}
+
+std::shared_ptr<Poller> makePoller() {
+  return makePoller(g_poller_type.load());
+}
+
+std::shared_ptr<Poller> makePoller(PollerType type) {
+  switch (type) {
+    case PollerType::Virtual:
+      return std::make_shared<VirtualPoller>();
+    case PollerType::Epoll:
+    default:
+      return std::make_shared<Epoller>();
+  }
+}
+
+}  // namespace core
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <list>
 #include <memory>
+#include <vector>
 #include "core/event.h"
 
 namespace core {
 
 class Poller {
  public:
+  // 累计负载统计，由Poller所在线程更新，可在任意线程读取
+  struct LoadStats {
+    int64_t busy_ns = 0;  // 等待之外的全部耗时，含任务与钩子
+    int64_t wait_ns = 0;  // 阻塞在epoll_wait中的耗时
+    uint64_t loops = 0;
+  };
+
   Poller() = default;
   virtual ~Poller() = default;
 
@@ -15,16 +24,65 @@ class Poller {
                             const Event::Handler& handler) = 0;
   virtual EventPtr addEvent(Events events, const Event::Handler& handler) = 0;
   virtual void rmEvent(int fd) = 0;
+  virtual void rmEvent(const EventPtr& event) = 0;
+
+  /**
+   * @brief
+   * 将事件连同处理函数、未处理的就绪状态一起迁移到target，
+   * 由当前Poller所在线程摘除后一次性投递给target，双方均无需等待
+   */
+  virtual void moveEvents(const std::vector<int>& fds,
+                          const std::shared_ptr<Poller>& target,
+                          Thread const* thd) = 0;
+  virtual void moveEvent(const EventPtr& event,
+                         const std::shared_ptr<Poller>& target) = 0;
+  virtual void moveTimer(int64_t timer_id,
+                         const std::shared_ptr<Poller>& target) = 0;
+  // 接收其他Poller迁移过来的事件
+  virtual void adopt(std::list<EventPtr>&& events) = 0;
 
   virtual void wakeup() const = 0;
-  virtual void run(int timeout = -1) = 0;
+  // 返回本轮派发的事件数
+  virtual int run(int timeout = -1) = 0;
+
+  // 最近一轮等待结束时采样的时间(us，steady clock)，可在任意线程读取
+  virtual int64_t now() const = 0;
+  // 当前的精确时间(us)，与now()同一时间基准
+  virtual int64_t preciseNow() const = 0;
 
+  virtual LoadStats stats() const = 0;
+  /**
+   * @brief
+   * 由Thread在最外层的每轮循环开始与结束时调用，两者之间run之外的工作
+   * (任务、钩子、空闲回调)计入忙碌，循环之外的时间不计入
+   */
+  virtual void beginLoop() = 0;
+  virtual void endLoop() = 0;
+  virtual bool profiling() const = 0;
+  // 开启后逐个记录事件处理耗时，每次派发多一次取时，返回之前的状态
+  virtual bool setProfiling(bool on) = 0;
+
+  /**
+   * @brief
+   * precise为false时以处理添加请求时的循环时间为起点，
+   * 否则以调用时的精确时间为起点，并在重设timerfd时重新取时
+   */
   virtual int64_t addTimer(int64_t microseconds,
                            const Event::Handler& handler,
-                           bool single_shot) = 0;
+                           bool single_shot,
+                           bool precise = false) = 0;
   virtual void rmTimer(int64_t timer_id) = 0;
 };
 
+enum class PollerType {
+  Epoll,
+  // 虚拟时钟：没有就绪的I/O时直接将时钟推进到下一个定时器的到期时间
+  Virtual,
+};
+
+// 设置之后创建的线程使用的Poller类型，默认Epoll
+void setPollerType(PollerType type);
 std::shared_ptr<Poller> makePoller();
+std::shared_ptr<Poller> makePoller(PollerType type);
 
 }  // namespace core
\ No newline at end of file
@@ -14,7 +14,9 @@
 namespace core {
 
 Epoller::Epoller()
-    : fd_(epoll_create1(EPOLL_CLOEXEC)),
+    : tick_(clock()),
+      now_(tick_ / 1000),
+      fd_(epoll_create1(EPOLL_CLOEXEC)),
       wake_fd_(eventfd(0, EFD_CLOEXEC)),
       timer_fd_(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
   if (fd_ == -1) {
@@ -35,6 +37,12 @@ Epoller::Epoller()
   handle();
 }
 
+Epoller::~Epoller() {
+  ::close(timer_fd_);
+  ::close(wake_fd_);
+  ::close(fd_);
+}
+
 EventPtr Epoller::addEvent(int fd,
                            Events events,
                            const Event::Handler& handler) {
@@ -46,7 +54,7 @@ EventPtr Epoller::addEvent(int fd,
 }
 
 EventPtr Epoller::addEvent(Events events, const Event::Handler& handler) {
-  return addEvent(eventfd(0, EFD_CLOEXEC), events, handler);
+  return addEvent(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK), events, handler);
 }
 
 void Epoller::rmEvent(int ev_fd) {
@@ -56,28 +64,151 @@ void Epoller::rmEvent(int ev_fd) {
   wakeup();
 }
 
-void Epoller::run(int timeout) {
+void Epoller::rmEvent(const EventPtr& event) {
+  Operation op{Operation::Type::DEL, event};
+  list_.push_back(op);
+  wakeup();
+}
+
+void Epoller::moveEvents(const std::vector<int>& fds,
+                         const std::shared_ptr<Poller>& target,
+                         Thread const* thd) {
+  std::list<Operation> ops;
+  for (auto fd : fds) {
+    ops.push_back(
+        Operation{Operation::Type::MOVE,
+                  create(fd, Events::Undefined, [](const Event*) {}), target,
+                  thd});
+  }
+  list_.push_back(std::move(ops));
+  wakeup();
+}
+
+void Epoller::moveEvent(const EventPtr& event,
+                        const std::shared_ptr<Poller>& target) {
+  Operation op{Operation::Type::MOVE, event, target};
+  list_.push_back(op);
+  wakeup();
+}
+
+void Epoller::moveTimer(int64_t timer_id,
+                        const std::shared_ptr<Poller>& target) {
+  auto p = std::make_shared<TimerEvent>();
+  p->id_ = timer_id;
+  p->type_ = static_cast<int>(EventType::Timer);
+  Operation op{Operation::Type::MOVE, p, target};
+  list_.push_back(op);
+  wakeup();
+}
+
+void Epoller::adopt(std::list<EventPtr>&& events) {
+  std::list<Operation> ops;
+  for (auto& ev : events) {
+    ops.push_back(Operation{Operation::Type::ADOPT, std::move(ev)});
+  }
+  list_.push_back(std::move(ops));
+  wakeup();
+}
+
+int Epoller::run(int timeout) {
+  // 本轮开始或上一轮派发结束后的其他工作(钩子、任务、延后的处理函数)计入忙碌
+  auto before = clock();
+  busy_ns_.fetch_add(before - tick_, std::memory_order_relaxed);
+  wait_since_.store(before, std::memory_order_relaxed);
   int nfds = epoll_wait(fd_, events_.data(), static_cast<int>(events_.size()),
                         timeout);
+  auto start = clock();
+  updateTime(start);
+  wait_ns_.fetch_add(start - before, std::memory_order_relaxed);
+  wait_since_.store(0, std::memory_order_relaxed);
+  auto profiling = profiling_.load(std::memory_order_relaxed);
+  auto last = start;
+  ++depth_;
   for (int i = 0; i < nfds; ++i) {
     int fd = events_[i].data.fd;
-    auto ev = maps_.at(fd);
-    ev->handler_(ev.get());
+    // 同一批次中靠前的处理函数可能已将该fd删除或迁出
+    auto iter = maps_.find(fd);
+    if (iter == maps_.end()) {
+      continue;
+    }
+    // 被删除的事件由retire保留，处理函数返回前不会析构
+    auto ev = iter->second.get();
+    ev->handler_(ev);
+    ev->hits_.fetch_add(1, std::memory_order_relaxed);
+    if (profiling) {
+      auto cur = clock();
+      ev->cost_.fetch_add(cur - last, std::memory_order_relaxed);
+      last = cur;
+    }
+  }
+  if (--depth_ == 0) {
+    retired_.clear();
+  }
+  auto end = profiling ? last : clock();
+
+  busy_ns_.fetch_add(end - start, std::memory_order_relaxed);
+  loops_.fetch_add(1, std::memory_order_relaxed);
+  tick_ = end;
+
+  return std::max(nfds, 0);
+}
+
+int64_t Epoller::now() const {
+  return now_.load(std::memory_order_relaxed);
+}
+
+int64_t Epoller::preciseNow() const {
+  return clock() / 1000;
+}
+
+void Epoller::updateTime(int64_t clock_ns) {
+  now_.store(clock_ns / 1000, std::memory_order_relaxed);
+}
+
+Poller::LoadStats Epoller::stats() const {
+  LoadStats ret;
+  ret.busy_ns = busy_ns_.load(std::memory_order_relaxed);
+  ret.wait_ns = wait_ns_.load(std::memory_order_relaxed);
+  ret.loops = loops_.load(std::memory_order_relaxed);
+  // 计入正在进行的等待，长时间阻塞的线程不会被误判为忙碌
+  if (auto since = wait_since_.load(std::memory_order_relaxed); since != 0) {
+    ret.wait_ns += clock() - since;
   }
+  return ret;
+}
+
+void Epoller::beginLoop() {
+  tick_ = clock();
+}
+
+void Epoller::endLoop() {
+  auto end = clock();
+  busy_ns_.fetch_add(end - tick_, std::memory_order_relaxed);
+  tick_ = end;
+}
+
+bool Epoller::profiling() const {
+  return profiling_.load(std::memory_order_relaxed);
+}
+
+bool Epoller::setProfiling(bool on) {
+  return profiling_.exchange(on);
 }
 
 int64_t Epoller::addTimer(int64_t microseconds,
                           const Event::Handler& handler,
-                          bool single_shot) {
+                          bool single_shot,
+                          bool precise) {
   auto p = std::make_shared<TimerEvent>();
   p->id_ = timer_counter_.fetch_add(1);
   p->single_shot_ = single_shot;
   p->timeout_ = microseconds;
   p->handler_ = handler;
-  p->expire_ = std::chrono::duration_cast<std::chrono::microseconds>(
-                   std::chrono::steady_clock::now().time_since_epoch())
-                   .count();
+  p->precise_ = precise;
+  // 非精确定时器在本线程处理添加请求时以循环时间为起点
+  p->expire_ = precise ? preciseNow() : 0;
   p->type_ = static_cast<int>(EventType::Timer);
+  p->status_ = EventStatus::NotReady;
 
   Operation op{Operation::Type::ADD, p};
   list_.push_back(op);
@@ -88,6 +219,7 @@ int64_t Epoller::addTimer(int64_t microseconds,
 void Epoller::rmTimer(int64_t timer_id) {
   auto p = std::make_shared<TimerEvent>();
   p->id_ = timer_id;
+  p->type_ = static_cast<int>(EventType::Timer);
   Operation op{Operation::Type::DEL, p};
   list_.push_back(op);
   wakeup();
@@ -106,13 +238,15 @@ EventPtr Epoller::create(int fd, Events events, const Event::Handler& handler) {
   ret->status_ = EventStatus::NotReady;
   ret->type_ = static_cast<int>(EventType::IO);
   if (static_cast<int>(ret->event_) & 0x04) {
-    std::weak_ptr<IOEvent> ev = ret;
+    // 处理函数归事件所有，被调用时事件必然存活
+    auto ev = ret.get();
     ret->handler_ = [ev, handler](const Event*) {
-      auto p = ev.lock();
-      if (p) {
-        Epoller::consume(p->fd_);
+      ev->count_ = Epoller::consume(ev->fd_);
+      if (ev->count_ == 0) {
+        // 计数已被读走(如迁移途中)，没有新的触发
+        return;
       }
-      handler(p.get());
+      handler(ev);
     };
   } else {
     ret->handler_ = handler;
@@ -121,14 +255,21 @@ EventPtr Epoller::create(int fd, Events events, const Event::Handler& handler) {
   return ret;
 }
 
-void Epoller::consume(int fd) {
-  uint64_t one;
-  auto size = ::read(fd, &one, sizeof(one));
-  UNUSED(size);
+int64_t Epoller::clock() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t Epoller::consume(int fd) {
+  uint64_t count;
+  auto size = ::read(fd, &count, sizeof(count));
+  return size == sizeof(count) ? count : 0;
 }
 
 void Epoller::handle() {
   std::list<Operation> list = list_.take();
+  MoveList moved;
 
   for (auto& l : list) {
     switch (l.type_) {
@@ -157,20 +298,128 @@ void Epoller::handle() {
           default:
             break;
         }
-        l.event_->status_ = EventStatus::NotReady;
       } break;
 
+      case Operation::Type::MOVE:
+        moveOut(l, moved);
+        break;
+
+      case Operation::Type::ADOPT:
+        adoptIn(l.event_, moved);
+        break;
+
       default:
         abort();
     }
   }
 
+  // 每个目标只投递一次
+  for (auto& [target, events] : moved) {
+    target->adopt(std::move(events));
+  }
+
   std::size_t new_size = std::max(maps_.size(), events_.size());
   events_.resize(new_size);
 
   resetTimer();
 }
 
+void Epoller::moveOut(const Operation& op, MoveList& moved) {
+  EventPtr ev;
+  switch (static_cast<EventType>(op.event_->type_)) {
+    case EventType::IO: {
+      auto io = std::static_pointer_cast<IOEvent>(op.event_);
+      auto iter = maps_.find(io->fd_);
+      // 按fd迁移时取当前注册的事件，按事件迁移时须是同一个事件
+      if (iter != maps_.end() &&
+          (io->event_ == Events::Undefined || iter->second == io)) {
+        ev = iter->second;
+      }
+    } break;
+
+    case EventType::Timer: {
+      auto id = std::static_pointer_cast<TimerEvent>(op.event_)->id_;
+      auto iter = std::find_if(timer_sequence_.begin(), timer_sequence_.end(),
+                               [id](const std::shared_ptr<TimerEvent>& e) {
+                                 return e->id_ == id;
+                               });
+      if (iter != timer_sequence_.end()) {
+        ev = *iter;
+      }
+    } break;
+
+    default:
+      break;
+  }
+
+  if (ev && detach(ev)) {
+    // 按fd迁移时由本线程标记迁移，按事件迁移时发起方已标记
+    auto status = EventStatus::Listen;
+    ev->status_.compare_exchange_strong(status, EventStatus::Moving);
+    if (status == EventStatus::NotReady) {
+      // 迁移请求发出后已被删除
+      return;
+    }
+    if (op.thd_) {
+      ev->thd_ = op.thd_;
+    }
+    moved[op.target_].push_back(ev);
+  } else if (op.event_->status_ == EventStatus::Moving) {
+    // 事件仍在迁往本线程的途中，到达后再转发
+    forwards_[op.event_.get()] = op.target_;
+  }
+}
+
+void Epoller::adoptIn(const EventPtr& ev, MoveList& moved) {
+  if (auto iter = forwards_.find(ev.get()); iter != forwards_.end()) {
+    moved[iter->second].push_back(ev);
+    forwards_.erase(iter);
+    return;
+  }
+
+  // 迁移途中已被删除
+  auto status = EventStatus::Moving;
+  if (!ev->status_.compare_exchange_strong(status, EventStatus::Listen)) {
+    return;
+  }
+
+  switch (static_cast<EventType>(ev->type_)) {
+    case EventType::IO:
+      addIO(std::static_pointer_cast<IOEvent>(ev));
+      break;
+    case EventType::Timer: {
+      auto timer = std::static_pointer_cast<TimerEvent>(ev);
+      if (cancelled_timers_.erase(timer->id_) == 1) {
+        timer->status_ = EventStatus::NotReady;
+        break;
+      }
+      insertTimer(timer);
+    } break;
+    default:
+      break;
+  }
+}
+
+bool Epoller::detach(const EventPtr& ev) {
+  switch (static_cast<EventType>(ev->type_)) {
+    case EventType::IO: {
+      auto io = std::static_pointer_cast<IOEvent>(ev);
+      epoll_ctl(fd_, EPOLL_CTL_DEL, io->fd_, nullptr);
+      maps_.erase(io->fd_);
+      retire(io);
+    } break;
+
+    case EventType::Timer:
+      timer_sequence_.remove(std::static_pointer_cast<TimerEvent>(ev));
+      break;
+
+    default:
+      return false;
+  }
+
+  return true;
+}
+
 void Epoller::addIO(const std::shared_ptr<IOEvent>& io) {
   struct epoll_event ev;
   memset(&ev, 0, sizeof(struct epoll_event));
@@ -182,31 +431,45 @@ void Epoller::addIO(const std::shared_ptr<IOEvent>& io) {
     ev.events |= EPOLLOUT;
   }
   ev.data.fd = io->fd_;
-  int type = maps_.count(io->fd_) == 1 ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
-  maps_.erase(io->fd_);
-  maps_.emplace(io->fd_, io);
+  auto iter = maps_.find(io->fd_);
+  int type = iter != maps_.end() ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  if (iter != maps_.end()) {
+    retire(std::move(iter->second));
+    iter->second = io;
+  } else {
+    maps_.emplace(io->fd_, io);
+  }
   fassert(-1 != epoll_ctl(fd_, type, ev.data.fd, &ev));
 }
 
 void Epoller::rmIO(const std::shared_ptr<IOEvent>& io) {
-  struct epoll_event ev;
-  memset(&ev, 0, sizeof(struct epoll_event));
-  auto events = static_cast<int>(io->event_);
-  if (events & 0x01) {
-    ev.events |= EPOLLIN;
+  auto iter = maps_.find(io->fd_);
+  // 按fd删除时删除当前注册的事件，按事件删除时须是同一个事件
+  if (iter != maps_.end() &&
+      (io->event_ == Events::Undefined || iter->second == io)) {
+    // fd可能已被使用者关闭，此时内核已自动将其移出epoll
+    epoll_ctl(fd_, EPOLL_CTL_DEL, io->fd_, nullptr);
+    iter->second->status_ = EventStatus::NotReady;
+    retire(std::move(iter->second));
+    maps_.erase(iter);
+    return;
   }
-  if (events & 0x02) {
-    ev.events |= EPOLLOUT;
-  }
-  ev.data.fd = io->fd_;
-  if (maps_.count(io->fd_) == 0) {
-    fassert(-1 != epoll_ctl(fd_, EPOLL_CTL_DEL, io->fd_, &ev));
-    maps_.erase(io->fd_);
+
+  // 事件仍在迁移途中，标记后由接收方丢弃
+  auto status = EventStatus::Moving;
+  io->status_.compare_exchange_strong(status, EventStatus::NotReady);
+}
+
+void Epoller::retire(EventPtr ev) {
+  if (depth_ > 0) {
+    retired_.push_back(std::move(ev));
   }
-  std::cout << "rm : " << io->fd_ << std::endl;
 }
 
 void Epoller::addTimer(const std::shared_ptr<TimerEvent>& timer) {
+  if (!timer->precise_) {
+    timer->expire_ = now_.load(std::memory_order_relaxed);
+  }
   sortTimer(timer);
 }
 
@@ -216,14 +479,17 @@ void Epoller::rmTimer(const std::shared_ptr<TimerEvent>& timer) {
                              return e->id_ == timer->id_;
                            });
   if (iter != timer_sequence_.end()) {
+    (*iter)->status_ = EventStatus::NotReady;
     timer_sequence_.erase(iter);
+  } else {
+    // 定时器可能仍在迁往本线程的途中
+    cancelled_timers_.insert(timer->id_);
   }
 }
 
-void Epoller::handleTimer() {
-  auto cur_ts = std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch())
-                    .count();
+int Epoller::handleTimer() {
+  // timerfd就绪后才采样的循环时间，不早于任何已到期的时间
+  auto cur_ts = now_.load(std::memory_order_relaxed);
 
   std::list<std::shared_ptr<TimerEvent>> timers;
 
@@ -244,10 +510,15 @@ void Epoller::handleTimer() {
   }
 
   resetTimer();
+  return static_cast<int>(timers.size());
 }
 
 void Epoller::sortTimer(const std::shared_ptr<TimerEvent>& timer) {
   timer->expire_ += timer->timeout_;
+  insertTimer(timer);
+}
+
+void Epoller::insertTimer(const std::shared_ptr<TimerEvent>& timer) {
   auto iter = timer_sequence_.begin();
   for (; iter != timer_sequence_.end(); ++iter) {
     if ((*iter)->expire_ > timer->expire_) {
@@ -262,10 +533,9 @@ void Epoller::resetTimer() {
   memset(&spec, 0, sizeof(struct itimerspec));
 
   if (!timer_sequence_.empty()) {
-    auto cost = timer_sequence_.front()->expire_ -
-                std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch())
-                    .count();
+    auto const& front = timer_sequence_.front();
+    auto cost = front->expire_ -
+                (front->precise_ ? preciseNow() : now_.load());
     int64_t nanoseconds = cost > 0 ? cost * 1000 : 1;
     spec.it_value.tv_sec = nanoseconds / 1000000000;
     spec.it_value.tv_nsec = nanoseconds % 1000000000;
@@ -273,8 +543,4 @@ void Epoller::resetTimer() {
   }
 }
 
-std::shared_ptr<Poller> makePoller() {
-  return std::make_shared<Epoller>();
-}
-
 }  // namespace core
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <thread>
+#include <unordered_set>
 
 #include <sys/epoll.h>
 
@@ -19,28 +21,77 @@ class Epoller : public Poller {
     enum class Type {
       DEL = -1,
       ADD = 1,
+      MOVE = 2,
+      ADOPT = 3,
     };
     Type type_;
-    EventPtr event_;
+    EventPtr event_ = nullptr;
+    // MOVE时的目标Poller与目标线程
+    std::shared_ptr<Poller> target_ = nullptr;
+    Thread const* thd_ = nullptr;
   };
 
+  using MoveList = std::map<std::shared_ptr<Poller>, std::list<EventPtr>>;
+
  public:
   Epoller();
+  ~Epoller() override;
 
   EventPtr addEvent(int fd,
                     Events events,
                     const Event::Handler& handler) override;
   EventPtr addEvent(Events events, const Event::Handler& handler) override;
   void rmEvent(int ev_fd) override;
+  void rmEvent(const EventPtr& event) override;
+
+  void moveEvents(const std::vector<int>& fds,
+                  const std::shared_ptr<Poller>& target,
+                  Thread const* thd) override;
+  void moveEvent(const EventPtr& event,
+                 const std::shared_ptr<Poller>& target) override;
+  void moveTimer(int64_t timer_id,
+                 const std::shared_ptr<Poller>& target) override;
+  void adopt(std::list<EventPtr>&& events) override;
+
   void wakeup() const override;
 
-  void run(int timeout = -1) override;
+  int run(int timeout = -1) override;
+
+  int64_t now() const override;
+  int64_t preciseNow() const override;
+  LoadStats stats() const override;
+  void beginLoop() override;
+  void endLoop() override;
+  bool profiling() const override;
+  bool setProfiling(bool on) override;
 
   int64_t addTimer(int64_t microseconds,
                    const Event::Handler& handler,
-                   bool single_shot) override;
+                   bool single_shot,
+                   bool precise = false) override;
   void rmTimer(int64_t timer_id) override;
 
+ protected:
+  // 处理已到期的定时器，返回执行的个数
+  int handleTimer();
+  // 按最早的到期时间重设timerfd
+  virtual void resetTimer();
+  // 每轮等待结束时以采样的时间(ns)更新循环时间
+  virtual void updateTime(int64_t clock_ns);
+
+  static int64_t clock();
+
+  std::list<std::shared_ptr<TimerEvent>> timer_sequence_;
+
+  std::atomic<int64_t> busy_ns_ = 0;
+  std::atomic<int64_t> wait_ns_ = 0;
+  std::atomic<uint64_t> loops_ = 0;
+  std::atomic<bool> profiling_ = false;
+  // 上一段计入忙碌或等待的时间的终点
+  int64_t tick_;
+  // 循环时间(us)
+  std::atomic<int64_t> now_;
+
  private:
   void handle();
 
@@ -50,12 +101,19 @@ class Epoller : public Poller {
   void addTimer(const std::shared_ptr<TimerEvent>& timer);
   void rmTimer(const std::shared_ptr<TimerEvent>& timer);
 
-  void handleTimer();
+  void moveOut(const Operation& op, MoveList& moved);
+  void adoptIn(const EventPtr& ev, MoveList& moved);
+  bool detach(const EventPtr& ev);
+
+  // 派发期间被移出的事件保留到最外层的派发结束，派发时无需持有引用
+  void retire(EventPtr ev);
+
   void sortTimer(const std::shared_ptr<TimerEvent>& timer);
-  void resetTimer();
+  void insertTimer(const std::shared_ptr<TimerEvent>& timer);
 
   static EventPtr create(int fd, Events events, const Event::Handler& handler);
-  static void consume(int fd);
+  // 读出并清零eventfd计数
+  static uint64_t consume(int fd);
 
   int fd_ = -1;
   int wake_fd_;
@@ -65,8 +123,17 @@ class Epoller : public Poller {
 
   std::unordered_map<int, std::shared_ptr<IOEvent>> maps_;
   std::vector<struct epoll_event> events_;
+  std::vector<EventPtr> retired_;
+  // run的嵌套深度(处理函数中可能调用processEvents)
+  int depth_ = 0;
 
-  std::list<std::shared_ptr<TimerEvent>> timer_sequence_;
+  // 迁移途中又被要求迁往别处的事件，到达后直接转发
+  std::unordered_map<Event*, std::shared_ptr<Poller>> forwards_;
+  // 迁移途中被删除的定时器，到达后直接丢弃
+  std::unordered_set<int64_t> cancelled_timers_;
+
+  // 阻塞等待开始的时间，不在等待时为0
+  std::atomic<int64_t> wait_since_ = 0;
 
   inline static std::atomic<int64_t> timer_counter_;
 };
@@ -0,0 +1,40 @@
+#include "core/poller/virtual_poller.h"
+
+#include <algorithm>
+
+namespace core {
+
+int VirtualPoller::run(int timeout) {
+  // 先处理已就绪的I/O和内部请求
+  int n = Epoller::run(0);
+  if (n > 0) {
+    return n;
+  }
+  // 没有定时器时只能等待外部事件
+  if (timer_sequence_.empty()) {
+    return Epoller::run(timeout);
+  }
+
+  auto cur = now_.load(std::memory_order_relaxed);
+  auto next = timer_sequence_.front()->expire_;
+  if (timeout >= 0 && next > cur + static_cast<int64_t>(timeout) * 1000) {
+    now_.store(cur + static_cast<int64_t>(timeout) * 1000,
+               std::memory_order_relaxed);
+    return 0;
+  }
+
+  now_.store(std::max(cur, next), std::memory_order_relaxed);
+  auto start = clock();
+  n = handleTimer();
+  auto end = clock();
+  busy_ns_.fetch_add(end - start, std::memory_order_relaxed);
+  loops_.fetch_add(1, std::memory_order_relaxed);
+  tick_ = end;
+  return n;
+}
+
+int64_t VirtualPoller::preciseNow() const {
+  return now_.load(std::memory_order_relaxed);
+}
+
+}  // namespace core
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "core/poller/epoller.h"
+
+namespace core {
+
+/**
+ * @brief
+ * 虚拟时钟的Poller，I/O与跨线程请求仍由epoll处理。
+ * 没有就绪的I/O和待执行的任务时不等待真实时间，
+ * 而是将时钟直接推进到最早的定时器到期时间并执行到期的定时器。
+ * 时钟从创建时的真实时间开始，每个实例独立，只在所属线程中推进。
+ * stats()中的busy_ns为真实的处理耗时，不包含被跳过的等待
+ */
+class VirtualPoller : public Epoller {
+ public:
+  VirtualPoller() = default;
+  ~VirtualPoller() override = default;
+
+  int run(int timeout = -1) override;
+
+  int64_t preciseNow() const override;
+
+ protected:
+  void resetTimer() override {}
+  void updateTime(int64_t) override {}
+};
+
+}  // namespace core
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "core/object.h"
+#include "core/thread.h"
+
+#include "utils/noncopyable.hpp"
+#include "utils/thread/annotations.hpp"
+
+/**
+ * @brief
+ * 类型化的信号与槽。
+ * 接收者与发送线程相同或没有接收者时直接调用；
+ * 接收者属于其他线程时，参数被复制后投递到接收者线程的事件循环，
+ * 同一信号发往同一线程的调用合并为一次投递，按发送顺序执行。
+ * 发送无锁：连接列表以快照读取，跨线程的调用压入目标线程的无锁队列，
+ * 直接调用不分配内存。发送时不访问接收者，接收者析构后其连接自动失效。
+ *
+ * e.g.
+ * class Connection : public core::Object {
+ *  public:
+ *   core::Signal<const std::string&> received;
+ * };
+ *
+ * conn.received.connect(&handler, &Handler::onReceived);
+ * conn.received.emit(data);
+ */
+
+namespace core {
+
+namespace detail {
+
+struct SlotBase {
+  virtual ~SlotBase() = default;
+  std::atomic<bool> connected_ = true;
+  // 接收者所在的线程，由接收者登记与迁移时更新，没有接收者时为空
+  std::atomic<Thread const*> thd_ = nullptr;
+};
+
+}  // namespace detail
+
+template <typename... Args>
+class Signal : public noncopyable {
+ public:
+  using Slot = std::function<void(Args...)>;
+
+  Signal() = default;
+  ~Signal() {
+    delete slots_.load();
+    for (auto& list : retired_list_) {
+      for (auto slots : list) {
+        delete slots;
+      }
+    }
+    for (auto target = targets_.load(); target;) {
+      auto next = target->next_;
+      delete target;
+      target = next;
+    }
+  }
+
+  // 没有接收者的连接总在发送线程中直接调用，返回连接id
+  uint64_t connect(const Slot& slot) { return connect(nullptr, slot); }
+
+  uint64_t connect(Object* receiver, const Slot& slot) {
+    auto data = std::make_shared<SlotData>();
+    data->slot_ = slot;
+
+    std::scoped_lock lck(mtx_);
+    data->id_ = ++counter_;
+    // 发布前登记，发送时读到的线程总是有效的
+    if (receiver) {
+      receiver->track(data);
+    }
+    update([&data](std::vector<std::shared_ptr<SlotData>>& items) {
+      items.push_back(data);
+    });
+    return data->id_;
+  }
+
+  template <typename R, typename... P>
+  uint64_t connect(R* receiver, void (R::*method)(P...)) {
+    return connect(receiver,
+                   [receiver, method](Args... args) {
+                     (receiver->*method)(std::forward<Args>(args)...);
+                   });
+  }
+
+  bool disconnect(uint64_t id) {
+    std::scoped_lock lck(mtx_);
+    bool found = false;
+    update([id, &found](std::vector<std::shared_ptr<SlotData>>& items) {
+      for (auto iter = items.begin(); iter != items.end(); ++iter) {
+        if ((*iter)->id_ == id) {
+          (*iter)->connected_ = false;
+          items.erase(iter);
+          found = true;
+          return;
+        }
+      }
+    });
+    return found;
+  }
+
+  void disconnectAll() {
+    std::scoped_lock lck(mtx_);
+    update([](std::vector<std::shared_ptr<SlotData>>& items) {
+      for (auto& item : items) {
+        item->connected_ = false;
+      }
+      items.clear();
+    });
+  }
+
+  std::size_t size() const {
+    Reader reader(this);
+    return reader.slots_ ? reader.slots_->size() : 0;
+  }
+
+  template <typename... A>
+  void emit(A&&... args) const {
+    Reader reader(this);
+    if (!reader.slots_) {
+      return;
+    }
+
+    Thread const* cur = nullptr;
+    for (auto const& data : *reader.slots_) {
+      if (!data->connected_.load(std::memory_order_acquire)) {
+        continue;
+      }
+      if (auto thd = data->thd_.load(std::memory_order_acquire); thd) {
+        if (!cur) {
+          cur = Thread::this_thread();
+        }
+        if (thd != cur) {
+          queue(thd, data, args...);
+          continue;
+        }
+      }
+      data->slot_(args...);
+    }
+  }
+
+  template <typename... A>
+  void operator()(A&&... args) const {
+    emit(std::forward<A>(args)...);
+  }
+
+ private:
+  struct SlotData : public detail::SlotBase {
+    uint64_t id_;
+    Slot slot_;
+  };
+
+  using Slots = std::vector<std::shared_ptr<SlotData>>;
+
+  struct Call {
+    std::shared_ptr<SlotData> data_;
+    std::tuple<std::decay_t<Args>...> args_;
+    Call* next_;
+  };
+
+  // 发往同一线程的待执行调用，发送者压栈，执行时整体取出并反转为发送顺序
+  struct Batch {
+    ~Batch() { drop(calls_.exchange(nullptr)); }
+
+    static void drop(Call* call) {
+      while (call) {
+        auto next = call->next_;
+        delete call;
+        call = next;
+      }
+    }
+
+    void run() {
+      Call* ordered = nullptr;
+      for (auto call = calls_.exchange(nullptr, std::memory_order_acquire);
+           call;) {
+        auto next = call->next_;
+        call->next_ = ordered;
+        ordered = call;
+        call = next;
+      }
+      // 槽抛出异常时释放剩余的调用
+      struct Guard {
+        Call*& rest_;
+        ~Guard() { drop(rest_); }
+      } guard{ordered};
+      while (ordered) {
+        std::unique_ptr<Call> call(ordered);
+        ordered = call->next_;
+        if (call->data_->connected_.load(std::memory_order_acquire)) {
+          std::apply(call->data_->slot_, call->args_);
+        }
+      }
+    }
+
+    std::atomic<Call*> calls_ = nullptr;
+  };
+
+  // 目标线程只增不删，个数不超过接收者所在的线程数
+  struct Target {
+    Thread const* thd_;
+    std::shared_ptr<Batch> batch_;
+    Target* next_;
+  };
+
+  /**
+   * @brief
+   * 读者登记在当前纪元后读取快照。写者将被替换的快照记入当前纪元，
+   * 上一纪元的读者全部离开后释放其记录的快照并切换纪元，
+   * 持续发送时旧纪元的读者只减不增，释放不会被新的读者推迟
+   */
+  struct Reader {
+    explicit Reader(const Signal* signal) : signal_(signal) {
+      for (;;) {
+        epoch_ = signal_->epoch_.load();
+        signal_->readers_[epoch_].fetch_add(1);
+        // 登记期间纪元已切换，重新登记
+        if (signal_->epoch_.load() == epoch_) {
+          break;
+        }
+        signal_->leave(epoch_);
+      }
+      slots_ = signal_->slots_.load();
+    }
+    ~Reader() { signal_->leave(epoch_); }
+
+    const Signal* signal_;
+    int epoch_;
+    const Slots* slots_;
+  };
+
+  void leave(int epoch) const {
+    if (readers_[epoch].fetch_sub(1) == 1 && retired_.load()) {
+      std::unique_lock lck(mtx_, std::try_to_lock);
+      // 未取得锁时留给之后的写者或读者
+      if (lck.owns_lock()) {
+        collect();
+      }
+    }
+  }
+
+  // 写时复制，被替换的快照在可能持有它的读者全部离开后释放
+  template <typename F>
+  void update(F&& f) {
+    auto old = slots_.load();
+    auto slots = old ? new Slots(*old) : new Slots();
+    f(*slots);
+    // 顺带清理接收者已析构的连接
+    slots->erase(std::remove_if(slots->begin(), slots->end(),
+                                [](const std::shared_ptr<SlotData>& data) {
+                                  return !data->connected_.load();
+                                }),
+                 slots->end());
+    slots_.store(slots);
+    if (old) {
+      retired_list_[epoch_.load()].push_back(old);
+      retired_ = true;
+    }
+    collect();
+  }
+
+  void collect() const {
+    for (int i = 0; i < 2; ++i) {
+      auto cur = epoch_.load();
+      auto prev = cur ^ 1;
+      if (readers_[prev].load() != 0) {
+        break;
+      }
+      for (auto slots : retired_list_[prev]) {
+        delete slots;
+      }
+      retired_list_[prev].clear();
+      if (retired_list_[cur].empty()) {
+        break;
+      }
+      // 此后的读者只能读到新的快照，当前纪元的读者离开后即可释放
+      epoch_.store(prev);
+    }
+    retired_ = !retired_list_[0].empty() || !retired_list_[1].empty();
+  }
+
+  const std::shared_ptr<Batch>& batch(Thread const* thd) const {
+    auto head = targets_.load(std::memory_order_acquire);
+    for (auto t = head; t; t = t->next_) {
+      if (t->thd_ == thd) {
+        return t->batch_;
+      }
+    }
+
+    auto target = new Target{thd, std::make_shared<Batch>(), head};
+    while (!targets_.compare_exchange_weak(target->next_, target,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+      // 其他发送者同时加入了目标线程
+      for (auto t = target->next_; t != head; t = t->next_) {
+        if (t->thd_ == thd) {
+          delete target;
+          return t->batch_;
+        }
+      }
+      head = target->next_;
+    }
+    return target->batch_;
+  }
+
+  template <typename... A>
+  void queue(Thread const* thd,
+             const std::shared_ptr<SlotData>& data,
+             A&... args) const {
+    auto& batch = this->batch(thd);
+    auto call =
+        new Call{data, std::tuple<std::decay_t<Args>...>(args...), nullptr};
+    auto head = batch->calls_.load(std::memory_order_relaxed);
+    do {
+      call->next_ = head;
+    } while (!batch->calls_.compare_exchange_weak(
+        head, call, std::memory_order_release, std::memory_order_relaxed));
+    // 由空变为非空的发送者负责投递
+    if (!head) {
+      thd->post([batch = batch]() { batch->run(); });
+    }
+  }
+
+  std::atomic<const Slots*> slots_ = nullptr;
+  mutable std::atomic<int> epoch_ = 0;
+  mutable std::atomic<int> readers_[2] = {0, 0};
+  mutable std::atomic<bool> retired_ = false;
+  mutable std::atomic<Target*> targets_ = nullptr;
+
+  mutable std::mutex mtx_;
+  mutable std::vector<const Slots*> retired_list_[2] GAURDED_BY(mtx_);
+  uint64_t counter_ GAURDED_BY(mtx_) = 0;
+};
+
+}  // namespace core
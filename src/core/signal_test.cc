@@ -0,0 +1,74 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/signal.h"
+#include "core/thread.h"
+
+// 信号发送耗时测试：./core.signal_test [次数，默认1000000]
+// 直接调用分别连接1个与1000个接收者，跨线程调用统计从发送到全部执行完成
+
+class Receiver : public core::Object {
+ public:
+  void onValue(int v) { sum_ += v; }
+  int64_t sum_ = 0;
+};
+
+static int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void direct(int receivers, int count) {
+  core::Signal<int> signal;
+  std::vector<std::unique_ptr<Receiver>> objs;
+  for (int i = 0; i < receivers; ++i) {
+    objs.emplace_back(std::make_unique<Receiver>());
+    signal.connect(objs.back().get(), &Receiver::onValue);
+  }
+
+  auto start = now_ns();
+  for (int i = 0; i < count; ++i) {
+    signal.emit(i);
+  }
+  auto cost = now_ns() - start;
+  std::cout << "direct emit to " << receivers
+            << " receivers: " << static_cast<double>(cost) / count
+            << " ns/emit, " << static_cast<double>(cost) / count / receivers
+            << " ns/slot" << std::endl;
+}
+
+static void queued(int count) {
+  core::Thread thd("receiver");
+  thd.start();
+  Receiver receiver;
+  receiver.moveToThread(&thd);
+
+  core::Signal<int> signal;
+  signal.connect(&receiver, &Receiver::onValue);
+  std::atomic<bool> done = false;
+  core::Signal<> finished;
+  finished.connect(&receiver, [&done]() { done = true; });
+
+  auto start = now_ns();
+  for (int i = 0; i < count; ++i) {
+    signal.emit(1);
+  }
+  finished.emit();
+  while (!done) {
+  }
+  auto cost = now_ns() - start;
+  std::cout << "queued emit to another thread: "
+            << static_cast<double>(cost) / count << " ns/emit" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1000000;
+  direct(1, count);
+  direct(1000, count / 1000);
+  queued(count);
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/signal.h"
+#include "core/thread.h"
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 2000) {
+  for (int i = 0; i < timeout_ms; ++i) {
+    if (pred()) {
+      return true;
+    }
+    usleep(1000);
+  }
+  return pred();
+}
+
+class Sender : public core::Object {
+ public:
+  core::Signal<int, const std::string&> notified;
+};
+
+class Receiver : public core::Object {
+ public:
+  void onNotified(int value, const std::string& text) {
+    thd_ = core::Thread::this_thread();
+    values_.push_back(value);
+    text_ = text;
+  }
+
+  std::atomic<core::Thread*> thd_ = nullptr;
+  std::vector<int> values_;
+  std::string text_;
+};
+
+}  // namespace
+
+TEST(Signal, Direct) {
+  Sender sender;
+  Receiver receiver;
+  int sum = 0;
+  auto id = sender.notified.connect([&sum](int v, const std::string&) {
+    sum += v;
+  });
+  sender.notified.connect(&receiver, &Receiver::onNotified);
+  EXPECT_EQ(sender.notified.size(), 2u);
+
+  sender.notified.emit(1, "a");
+  sender.notified(2, "b");
+  EXPECT_EQ(sum, 3);
+  EXPECT_EQ(receiver.values_, (std::vector<int>{1, 2}));
+  EXPECT_EQ(receiver.text_, "b");
+
+  EXPECT_TRUE(sender.notified.disconnect(id));
+  EXPECT_FALSE(sender.notified.disconnect(id));
+  sender.notified.emit(3, "c");
+  EXPECT_EQ(sum, 3);
+  EXPECT_EQ(receiver.values_.size(), 3u);
+}
+
+TEST(Signal, ReceiverDestroyed) {
+  Sender sender;
+  {
+    Receiver receiver;
+    sender.notified.connect(&receiver, &Receiver::onNotified);
+    sender.notified.emit(1, "a");
+    EXPECT_EQ(receiver.values_.size(), 1u);
+  }
+  // 接收者析构后连接失效
+  sender.notified.emit(2, "b");
+
+  int hits = 0;
+  sender.notified.connect([&hits](int, const std::string&) { ++hits; });
+  EXPECT_EQ(sender.notified.size(), 1u);
+  sender.notified.emit(3, "c");
+  EXPECT_EQ(hits, 1);
+}
+
+TEST(Signal, Queued) {
+  core::Thread a("a");
+  a.start();
+
+  Sender sender;
+  Receiver receiver;
+  receiver.moveToThread(&a);
+  sender.notified.connect(&receiver, &Receiver::onNotified);
+
+  // 发往其他线程的调用在接收者线程中按顺序执行
+  std::atomic<bool> release = false;
+  a.post([&]() {
+    while (!release) {
+      usleep(100);
+    }
+  });
+  for (int i = 0; i < 100; ++i) {
+    sender.notified.emit(i, std::to_string(i));
+  }
+  release = true;
+
+  ASSERT_TRUE(waitFor([&]() { return receiver.thd_ != nullptr; }));
+  a.post([&]() { receiver.thd_ = nullptr; });
+  ASSERT_TRUE(waitFor([&]() { return receiver.thd_ == nullptr; }));
+  a.stop();
+  a.wait();
+
+  ASSERT_EQ(receiver.values_.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(receiver.values_[i], i);
+  }
+  EXPECT_EQ(receiver.text_, "99");
+}
+
+TEST(Signal, MoveAfterConnect) {
+  core::Thread a("a");
+  a.start();
+
+  Sender sender;
+  Receiver receiver;
+  sender.notified.connect(&receiver, &Receiver::onNotified);
+  sender.notified.emit(1, "a");
+  EXPECT_EQ(receiver.thd_, core::Thread::this_thread());
+
+  // 连接随接收者迁往新线程
+  receiver.moveToThread(&a);
+  sender.notified.emit(2, "b");
+  ASSERT_TRUE(waitFor([&]() { return receiver.thd_ == &a; }));
+  a.stop();
+  a.wait();
+  EXPECT_EQ(receiver.values_, (std::vector<int>{1, 2}));
+}
+
+TEST(Signal, ConcurrentUpdate) {
+  core::Thread a("a");
+  a.start();
+
+  // 持续发送的同时增删连接，并在接收者线程中反复创建和析构接收者
+  Sender sender;
+  std::atomic<bool> done = false;
+  std::atomic<int> hits = 0;
+  std::thread writer([&]() {
+    for (int i = 0; i < 2000; ++i) {
+      auto id = sender.notified.connect(
+          [&hits](int, const std::string&) { ++hits; });
+      a.post([&sender]() {
+        Receiver receiver;
+        sender.notified.connect(&receiver, &Receiver::onNotified);
+      });
+      sender.notified.disconnect(id);
+    }
+    done = true;
+  });
+  while (!done) {
+    sender.notified.emit(0, "x");
+  }
+  writer.join();
+
+  // 发送中修改连接，新连接从下一次发送开始生效
+  int nested = 0;
+  sender.notified.connect([&](int, const std::string&) {
+    if (nested++ == 0) {
+      sender.notified.connect([&nested](int, const std::string&) {
+        nested += 10;
+      });
+    }
+  });
+  sender.notified.emit(0, "y");
+  EXPECT_EQ(nested, 1);
+  sender.notified.emit(0, "z");
+  EXPECT_EQ(nested, 12);
+
+  a.stop();
+  a.wait();
+}
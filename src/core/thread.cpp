@@ -2,12 +2,18 @@
 
 #include <sys/eventfd.h>
 #include <sys/prctl.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+
+#include "core/object.h"
 #include "core/poller.h"
 
 #include "utils/assert.h"
 #include "utils/thread/thread_local_storage.hpp"
-#include "utils/time.hpp"
+#include "utils/thread/wait.hpp"
 
 namespace core {
 
@@ -17,32 +23,118 @@ const static utils::thread::ThreadLocalStorage<Thread*> current_thd =
       return p;
     });
 
+namespace {
+
+// 所有存活的线程，退出时统一停止与等待
+struct Registry {
+  std::mutex mtx_;
+  // 线程退出或经过静止点时通知，供Application::shutdown与synchronize等待
+  std::condition_variable cv_;
+  std::vector<Thread*> thds_ GAURDED_BY(mtx_);
+  // 正在synchronize的线程数，非零时经过静止点的线程才通知cv_
+  std::atomic<int> waiters_ = 0;
+};
+
+// 处理函数长时间阻塞的线程迟迟不经过静止点，synchronize按该间隔复查并再次唤醒
+constexpr auto kRecheck = std::chrono::milliseconds(100);
+
+Registry& registry() {
+  static Registry inst;
+  return inst;
+}
+
+}  // namespace
+
 Thread* Thread::this_thread() {
   auto thd = (*current_thd);
   return thd == nullptr ? Application::thread() : thd;
 }
 
+bool Thread::inEventLoop() {
+  return *current_thd != nullptr;
+}
+
+int64_t Thread::now(bool precise) {
+  auto& poller = this_thread()->poller_;
+  // 调用线程没有运行事件循环时，主线程的循环时间不随其推进
+  if (!inEventLoop()) {
+    return poller->preciseNow();
+  }
+  return precise ? poller->preciseNow() : poller->now();
+}
+
+void Thread::synchronize() {
+  auto self = *current_thd;
+  std::vector<std::pair<Thread*, uint64_t>> pending;
+  auto& reg = registry();
+  std::unique_lock lck(reg.mtx_);
+  // 先登记再读取计数，runOnce则先递增计数再检查waiters_，
+  // 两侧均为顺序一致的原子操作，至少有一侧看到另一侧，通知不会丢失
+  reg.waiters_.fetch_add(1);
+  for (auto thd : reg.thds_) {
+    if (thd != self && thd->status() == Status::Running) {
+      pending.emplace_back(thd, thd->quiescent_.load());
+      // 阻塞等待中的线程被唤醒后立即经过静止点
+      thd->poller_->wakeup();
+    }
+  }
+
+  auto passed = [&reg, &pending]() {
+    pending.erase(
+        std::remove_if(pending.begin(), pending.end(),
+                       [&reg](const std::pair<Thread*, uint64_t>& p) {
+                         // 已析构、已退出或已经过静止点
+                         auto iter = std::find(reg.thds_.begin(),
+                                               reg.thds_.end(), p.first);
+                         return iter == reg.thds_.end() ||
+                                p.first->status() != Status::Running ||
+                                p.first->quiescent_.load() != p.second;
+                       }),
+        pending.end());
+    return pending.empty();
+  };
+  while (!reg.cv_.wait_for(lck, kRecheck, passed)) {
+    // 持有锁且刚检查过，剩余的线程均未析构
+    for (auto& p : pending) {
+      p.first->poller_->wakeup();
+    }
+  }
+  reg.waiters_.fetch_sub(1);
+}
+
 Thread::Thread(const std::string& name /* = "" */)
-    : poller_(makePoller()), status_(Status::Exit), thd_name_(name) {}
+    : poller_(makePoller()), status_(Status::Exit), thd_name_(name) {
+  auto& reg = registry();
+  std::scoped_lock lck(reg.mtx_);
+  reg.thds_.push_back(this);
+}
 
 Thread::~Thread() {
-  std::scoped_lock lck(mtx_);
-  if (!run_) {
-    return;
+  {
+    auto& reg = registry();
+    std::scoped_lock lck(reg.mtx_);
+    reg.thds_.erase(std::find(reg.thds_.begin(), reg.thds_.end(), this));
   }
-  stop();
+
+  Thread::stop();
   if (thd_.joinable()) {
     thd_.join();
   }
 }
 
 void Thread::start() {
-  std::scoped_lock lck(mtx_);
+  std::scoped_lock start_lck(start_mtx_);
   if (run_) {
     return;
   }
 
+  // 上一次stop()后的事件循环退出时需要mtx_，须在持有mtx_之前回收
+  if (thd_.joinable()) {
+    thd_.join();
+  }
+  std::scoped_lock lck(mtx_);
   run_ = true;
+  status_ = Status::Starting;
   std::thread thd([this]() { threadMain(); });
   thd_.swap(thd);
 }
@@ -74,47 +166,407 @@ Trigger Thread::addEvent(const Events event,
   return ret;
 }
 
+Trigger Thread::addEvent(const int fd,
+                         const Events event,
+                         const Event::Handler& handler,
+                         int64_t budget) const {
+  return addEvent(fd, event, deferred(handler, budget));
+}
+
+Trigger Thread::addEvent(const Events event,
+                         const Event::Handler& handler,
+                         int64_t budget) const {
+  return addEvent(event, deferred(handler, budget));
+}
+
+Event::Handler Thread::deferred(const Event::Handler& handler,
+                                int64_t budget) const {
+  return [handler, budget](const Event* ev) {
+    if (!ev) {
+      return;
+    }
+    // 事件可能随后被迁移，由当前派发的线程调度
+    std::weak_ptr<const Event> weak = ev->weak_from_this();
+    auto thd = this_thread();
+    thd->schedule(
+        [handler, weak, thd]() {
+          auto p = weak.lock();
+          if (!p) {
+            return;
+          }
+          // 处理函数的耗时计入其事件，供负载均衡使用
+          if (!thd->poller_->profiling()) {
+            handler(p.get());
+            return;
+          }
+          auto begin = std::chrono::steady_clock::now();
+          handler(p.get());
+          p->cost_.fetch_add(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - begin)
+                  .count(),
+              std::memory_order_relaxed);
+        },
+        thd->poller_->now() + budget, false);
+  };
+}
+
 void Thread::removeEvent(const int ev_fd) const {
   poller_->rmEvent(ev_fd);
 }
 
+void Thread::removeEvent(const EventPtr& ev) const {
+  poller_->rmEvent(ev);
+}
+
+void Thread::moveEvents(const std::vector<int>& fds, Thread const* thd) const {
+  if (thd == this || fds.empty()) {
+    return;
+  }
+  poller_->moveEvents(fds, thd->poller_, thd);
+}
+
+void Thread::moveEvent(const EventPtr& ev, Thread const* thd) const {
+  if (thd == this) {
+    return;
+  }
+  poller_->moveEvent(ev, thd->poller_);
+}
+
 int Thread::addTimer(int64_t microseconds,
                      const Event::Handler& handler,
-                     bool single_shot) const {
-  return poller_->addTimer(microseconds, handler, single_shot);
+                     bool single_shot,
+                     bool precise) const {
+  return poller_->addTimer(microseconds, handler, single_shot, precise);
 }
 
 void Thread::removeTimer(int timer_id) const {
   poller_->rmTimer(timer_id);
 }
 
+void Thread::moveTimer(int timer_id, Thread const* thd) const {
+  if (thd == this) {
+    return;
+  }
+  poller_->moveTimer(timer_id, thd->poller_);
+}
+
 void Thread::processEvents(int max_time) const {
   if (this_thread() != this) {
     return;
   }
 
+  // 每轮迭代都会更新循环时间，无需额外取时
+  auto deadline = now(true) + static_cast<int64_t>(max_time) * 1000;
+  auto remain = max_time;
   do {
-    auto start = utils::time::get_cur_ts();
-    poller_->run(max_time);
-    auto cost = utils::time::get_cur_ts() - start;
-    max_time -= cost;
-  } while (max_time > 0);
+    runOnce(remain);
+    remain = static_cast<int>((deadline - poller_->now()) / 1000);
+  } while (remain > 0);
+}
+
+void Thread::post(const Task& task) const {
+  if (tasks_.push_back(Scheduled{task, kNoDeadline, false})) {
+    poller_->wakeup();
+  }
+}
+
+void Thread::post(const Task& task, int64_t deadline) const {
+  if (tasks_.push_back(Scheduled{task, deadline, true})) {
+    poller_->wakeup();
+  }
+}
+
+void Thread::deleteLater(Object* obj) const {
+  if (deletes_.push_back(Deletion{obj, obj->weak_from_this().lock()})) {
+    poller_->wakeup();
+  }
+}
+
+Thread::DeadlineStats Thread::deadlineStats() const {
+  DeadlineStats ret;
+  ret.executed = executed_.load(std::memory_order_relaxed);
+  ret.shed = shed_.load(std::memory_order_relaxed);
+  ret.late = late_.load(std::memory_order_relaxed);
+  return ret;
+}
+
+Thread::Status Thread::status() const {
+  std::scoped_lock lck(mtx_);
+  return status_;
+}
+
+bool Thread::wait(int timeout) {
+  std::unique_lock lck(mtx_);
+  auto exited = [this]() { return status_ == Status::Exit; };
+  // 在自身的事件循环中等待自己退出会死锁
+  if (this_thread() == this) {
+    return exited();
+  }
+
+  if (timeout < 0) {
+    utils::thread::wait(cv_, lck, exited);
+    return true;
+  }
+  return cv_.wait_for(lck, std::chrono::milliseconds(timeout), exited);
+}
+
+void Thread::setDrainTimeout(int timeout) {
+  drain_timeout_ = timeout;
+}
+
+int Thread::addHook(Phase phase, const Task& hook) const {
+  std::scoped_lock lck(hook_mtx_);
+  auto hooks = hooks_ ? std::make_shared<Hooks>(*hooks_)
+                      : std::make_shared<Hooks>();
+  auto id = ++hook_id_;
+  (phase == Phase::Prepare ? hooks->prepare_ : hooks->check_)
+      .emplace_back(id, hook);
+  hooks_ = hooks;
+  return id;
+}
+
+int Thread::addIdle(const IdleTask& task) const {
+  int id;
+  {
+    std::scoped_lock lck(hook_mtx_);
+    auto hooks = hooks_ ? std::make_shared<Hooks>(*hooks_)
+                        : std::make_shared<Hooks>();
+    id = ++hook_id_;
+    hooks->idle_.emplace_back(id, task);
+    hooks_ = hooks;
+  }
+  // 唤醒可能正在休眠的事件循环，使其重新判断是否空闲
+  poller_->wakeup();
+  return id;
+}
+
+void Thread::removeHook(int id) const {
+  std::scoped_lock lck(hook_mtx_);
+  if (!hooks_) {
+    return;
+  }
+
+  auto hooks = std::make_shared<Hooks>(*hooks_);
+  auto erase = [id](auto& vec) {
+    vec.erase(std::remove_if(vec.begin(), vec.end(),
+                             [id](auto const& h) { return h.first == id; }),
+              vec.end());
+  };
+  erase(hooks->prepare_);
+  erase(hooks->check_);
+  erase(hooks->idle_);
+  hooks_ = hooks;
+}
+
+void Thread::setIdleBudget(int64_t microseconds) {
+  idle_budget_ = microseconds;
+}
+
+Poller::LoadStats Thread::load() const {
+  return poller_->stats();
+}
+
+bool Thread::setProfiling(bool on) const {
+  return poller_->setProfiling(on);
 }
 
 void Thread::threadMain() {
-  status_ = Status::Starting;
   *current_thd = this;
   if (!thd_name_.empty()) {
     prctl(PR_SET_NAME, thd_name_.c_str());
   }
+  {
+    // 订阅的信号统一由主线程的signalfd处理
+    auto& app = Application::instance();
+    std::scoped_lock lck(app.mtx_);
+    pthread_sigmask(SIG_BLOCK, &app.mask_, nullptr);
+  }
 
-  status_ = Status::Running;
+  setStatus(Status::Running);
   while (run_) {
-    poller_->run();
+    runOnce(-1);
   }
+  drain();
   *current_thd = nullptr;
 
-  status_ = Status::Exit;
+  setStatus(Status::Exit);
+}
+
+void Thread::runOnce(int timeout) const {
+  auto outer = depth_ == 0;
+  if (outer) {
+    quiescent_.fetch_add(1);
+    auto& reg = registry();
+    if (reg.waiters_.load() > 0) {
+      // 等待者在持有registry锁时检查计数，经过该锁再通知以免唤醒丢失
+      { std::scoped_lock lck(reg.mtx_); }
+      reg.cv_.notify_all();
+    }
+    poller_->beginLoop();
+  }
+  ++depth_;
+  runHooks(Phase::Prepare);
+  auto busy = !tasks_.empty() || !deletes_.empty() || idle_pending_;
+  auto n = poller_->run(busy ? 0 : timeout);
+  n += runTasks();
+  runHooks(Phase::Check);
+  n += runDeletes();
+  --depth_;
+
+  if (n > 0) {
+    // 有过工作，下一轮先不休眠，确认空闲后再执行空闲回调
+    std::scoped_lock lck(hook_mtx_);
+    idle_pending_ = hooks_ && !hooks_->idle_.empty();
+  } else {
+    runIdle();
+  }
+  if (outer) {
+    poller_->endLoop();
+  }
+}
+
+std::size_t Thread::runTasks() const {
+  auto tasks = tasks_.take();
+  auto n = tasks.size();
+  for (auto iter = tasks.begin(); iter != tasks.end();) {
+    if (iter->deadline_ == kNoDeadline) {
+      ++iter;
+      continue;
+    }
+    schedule(iter->task_, iter->deadline_, iter->shed_);
+    iter = tasks.erase(iter);
+  }
+
+  runDeadlines();
+  for (auto& t : tasks) {
+    t.task_();
+  }
+  return n;
+}
+
+std::size_t Thread::runDeletes() const {
+  // 外层的处理函数可能仍在使用待析构的对象
+  if (depth_ > 1) {
+    return 0;
+  }
+
+  std::size_t n = 0;
+  // 析构函数中可能再次调用deleteLater
+  while (!deletes_.empty()) {
+    auto list = deletes_.take();
+    for (auto& d : list) {
+      if (!d.keep_) {
+        delete d.obj_;
+      }
+    }
+    n += list.size();
+  }
+  return n;
+}
+
+void Thread::schedule(const Task& task, int64_t deadline, bool shed) const {
+  deadlines_.push_back(Scheduled{task, deadline, shed});
+  std::push_heap(deadlines_.begin(), deadlines_.end(),
+                 [](const Scheduled& l, const Scheduled& r) {
+                   return l.deadline_ > r.deadline_;
+                 });
+}
+
+std::size_t Thread::runDeadlines() const {
+  if (deadlines_.empty()) {
+    return 0;
+  }
+
+  auto later = [](const Scheduled& l, const Scheduled& r) {
+    return l.deadline_ > r.deadline_;
+  };
+  std::size_t n = 0;
+  // 上一个任务的完成时间即下一个任务的开始时间，每个任务只取一次时
+  auto cur = now(true);
+  while (!deadlines_.empty()) {
+    std::pop_heap(deadlines_.begin(), deadlines_.end(), later);
+    auto item = std::move(deadlines_.back());
+    deadlines_.pop_back();
+    if (item.shed_ && cur > item.deadline_) {
+      shed_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    item.task_();
+    ++n;
+    cur = now(true);
+    if (cur > item.deadline_) {
+      late_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  executed_.fetch_add(n, std::memory_order_relaxed);
+  return n;
+}
+
+void Thread::runHooks(Phase phase) const {
+  std::shared_ptr<const Hooks> hooks;
+  {
+    std::scoped_lock lck(hook_mtx_);
+    hooks = hooks_;
+  }
+  if (!hooks) {
+    return;
+  }
+
+  for (auto& [id, hook] :
+       phase == Phase::Prepare ? hooks->prepare_ : hooks->check_) {
+    hook();
+  }
+}
+
+void Thread::runIdle() const {
+  std::shared_ptr<const Hooks> hooks;
+  {
+    std::scoped_lock lck(hook_mtx_);
+    hooks = hooks_;
+  }
+  idle_pending_ = false;
+  if (!hooks || hooks->idle_.empty()) {
+    return;
+  }
+
+  // 轮转起点，预算不足时保证每个回调都有机会执行
+  auto const& idle = hooks->idle_;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(idle_budget_.load());
+  for (std::size_t i = 0; i < idle.size(); ++i) {
+    auto& task = idle[(idle_cursor_ + i) % idle.size()].second;
+    idle_pending_ |= task();
+    if (std::chrono::steady_clock::now() >= deadline) {
+      idle_cursor_ = (idle_cursor_ + i + 1) % idle.size();
+      idle_pending_ = true;
+      return;
+    }
+  }
+}
+
+void Thread::drain() const {
+  auto deadline = poller_->now() + static_cast<int64_t>(drain_timeout_) * 1000;
+  while (poller_->run(0) + runTasks() + runDeletes() > 0 &&
+         poller_->now() < deadline) {
+  }
+  // 对象不随超时遗留
+  runDeletes();
+}
+
+void Thread::setStatus(Status status) {
+  {
+    std::scoped_lock lck(mtx_);
+    status_ = status;
+  }
+  cv_.notify_all();
+  if (status == Status::Exit) {
+    // 等待者在持有registry锁时检查状态，经过该锁再通知以免唤醒丢失
+    auto& reg = registry();
+    { std::scoped_lock lck(reg.mtx_); }
+    reg.cv_.notify_all();
+  }
 }
 
 class MainThread : public Thread {
@@ -122,24 +574,23 @@ class MainThread : public Thread {
   MainThread() = default;
 
   int exec() {
+    // 供synchronize区分主循环线程与未运行事件循环的线程
+    *current_thd = this;
     run_ = true;
-    status_ = Status::Starting;
-
-    status_ = Status::Running;
+    setStatus(Status::Running);
     while (run_) {
-      poller_->run();
+      runOnce(-1);
     }
-
-    status_ = Status::Exit;
+    drain();
+    *current_thd = nullptr;
+    setStatus(Status::Exit);
 
     return 0;
   }
 
-  void exit() {
+  void quit() {
     run_ = false;
-    while (status_ != Status::Exit) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    poller_->wakeup();
   }
 
   void start() override {}
@@ -147,22 +598,114 @@ class MainThread : public Thread {
   void join() override {}
 };
 
-Application::Application() : thd_(new MainThread) {}
+Application::Application() : thd_(new MainThread) {
+  sigemptyset(&mask_);
+}
+
 Application::~Application() {
+  signal_trigger_.reset();
+  if (signal_fd_ != -1) {
+    ::close(signal_fd_);
+  }
   delete thd_;
   thd_ = nullptr;
 }
 
 int Application::exec() {
-  return instance().thd_->exec();
+  auto& app = instance();
+  app.quitting_ = false;
+  app.thd_->exec();
+  return app.code_;
 }
 
-void Application::exit() {
-  instance().thd_->exit();
+void Application::exit(int code) {
+  auto& app = instance();
+  if (app.quitting_.exchange(true)) {
+    return;
+  }
+  app.code_ = code;
+  app.thd_->post([]() { instance().shutdown(); });
 }
 
 Thread* Application::thread() {
   return instance().thd_;
 }
 
+void Application::onSignal(int signo, const SignalHandler& handler) {
+  auto& app = instance();
+  std::scoped_lock lck(app.mtx_);
+  app.signal_handlers_[signo].push_back(handler);
+  if (sigismember(&app.mask_, signo)) {
+    return;
+  }
+
+  sigaddset(&app.mask_, signo);
+  pthread_sigmask(SIG_BLOCK, &app.mask_, nullptr);
+  if (app.signal_fd_ != -1) {
+    fassert(-1 != signalfd(app.signal_fd_, &app.mask_, 0));
+    return;
+  }
+
+  app.signal_fd_ = signalfd(-1, &app.mask_, SFD_NONBLOCK | SFD_CLOEXEC);
+  fassert(app.signal_fd_ != -1);
+  app.signal_trigger_.emplace(app.thd_->addEvent(
+      app.signal_fd_, Events::ReadOnly,
+      [](const Event*) { instance().handleSignals(); }));
+}
+
+void Application::onQuit(const Thread::Task& hook) {
+  auto& app = instance();
+  std::scoped_lock lck(app.mtx_);
+  app.quit_hooks_.push_back(hook);
+}
+
+void Application::shutdown() {
+  std::vector<Thread::Task> hooks;
+  {
+    std::scoped_lock lck(mtx_);
+    hooks = quit_hooks_;
+  }
+  for (auto& hook : hooks) {
+    hook();
+  }
+
+  {
+    // 持有锁期间线程对象不会被析构
+    auto& reg = registry();
+    std::unique_lock lck(reg.mtx_);
+    for (auto thd : reg.thds_) {
+      if (thd != thd_) {
+        thd->Thread::stop();
+      }
+    }
+    // 等待期间释放锁，退出前的处理函数可以创建或析构线程
+    utils::thread::wait(reg.cv_, lck, [this, &reg]() {
+      return std::all_of(reg.thds_.begin(), reg.thds_.end(),
+                         [this](Thread* thd) {
+                           return thd == thd_ ||
+                                  thd->status() == Thread::Status::Exit;
+                         });
+    });
+  }
+
+  thd_->quit();
+}
+
+void Application::handleSignals() {
+  struct signalfd_siginfo info;
+  while (::read(signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+    std::vector<SignalHandler> handlers;
+    {
+      std::scoped_lock lck(mtx_);
+      if (auto iter = signal_handlers_.find(static_cast<int>(info.ssi_signo));
+          iter != signal_handlers_.end()) {
+        handlers = iter->second;
+      }
+    }
+    for (auto& handler : handlers) {
+      handler(static_cast<int>(info.ssi_signo));
+    }
+  }
+}
+
 }  // namespace core
\ No newline at end of file
@@ -1,22 +1,44 @@
 #pragma once
 
+#include <signal.h>
 #include <thread>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <optional>
+#include <vector>
 
 #include "core/event.h"
+#include "core/poller.h"
 #include "core/timer.h"
 
 #include <mutex>
 #include "utils/thread/annotations.hpp"
+#include "utils/thread/list.hpp"
 
 namespace core {
 
-class Poller;
+class Object;
 
 class Thread {
  public:
+  using Task = std::function<void()>;
+  // 返回true表示仍有剩余工作，事件循环不会进入休眠
+  using IdleTask = std::function<bool()>;
+
   static Thread* this_thread();
+  // 调用线程是否在运行事件循环，否则this_thread()为主线程
+  static bool inEventLoop();
+  /**
+   * @brief
+   * 当前线程事件循环的时间(us，steady clock)，每轮等待结束时采样一次，
+   * 处理函数中读取无需系统调用。precise为true或调用线程没有运行事件循环时
+   * 读取精确时间
+   */
+  static int64_t now(bool precise = false);
 
   enum class Status {
     Starting,
@@ -24,6 +46,29 @@ class Thread {
     Exit,
   };
 
+  // 带截止时间的任务与事件的调度统计
+  struct DeadlineStats {
+    uint64_t executed = 0;  // 已执行
+    uint64_t shed = 0;      // 开始前已超过截止时间而被丢弃
+    uint64_t late = 0;      // 执行完成时已超过截止时间
+  };
+
+  enum class Phase {
+    Prepare,  // 每轮等待事件之前
+    Check,    // 每轮就绪事件和任务处理完之后
+  };
+
+  /**
+   * @brief
+   * 等待宽限期：所有运行中的线程各自经过一个静止点(一轮迭代开始，
+   * 没有处理函数在执行)。调用前以原子操作替换的指针，
+   * 返回后不再被任何线程的处理函数持有，旧对象可以安全释放。
+   * 调用线程自身视为已静止，不得在处理函数中等待其他线程的宽限期时持有旧指针。
+   * 等待期间各线程经过静止点时通知调用方；处理函数阻塞的线程每隔100ms复查一次，
+   * 宽限期持续到其返回
+   */
+  static void synchronize();
+
   explicit Thread(const std::string& name = "");
   virtual ~Thread();
 
@@ -39,26 +84,157 @@ class Thread {
                    const Events event,
                    const Event::Handler& handler) const;
   Trigger addEvent(const Events event, const Event::Handler& handler) const;
+  /**
+   * @brief
+   * 事件就绪后处理函数须在budget(us)内开始执行，
+   * 与带截止时间的任务一起按截止时间先后调度。
+   * 未处理的就绪状态会保留，超时的事件不会被丢弃，只计入late
+   */
+  Trigger addEvent(const int fd,
+                   const Events event,
+                   const Event::Handler& handler,
+                   int64_t budget) const;
+  Trigger addEvent(const Events event,
+                   const Event::Handler& handler,
+                   int64_t budget) const;
   void removeEvent(const int fd) const;
+  void removeEvent(const EventPtr& ev) const;
+
+  /**
+   * @brief
+   * 将本线程上的事件迁移到thd，处理函数与未处理的就绪状态随之迁移。
+   * 同一批fd只产生一次跨线程投递，调用方与双方线程均不等待
+   */
+  void moveEvents(const std::vector<int>& fds, Thread const* thd) const;
+  void moveEvent(const EventPtr& ev, Thread const* thd) const;
 
+  // precise为false时到期时间基于循环时间，可能晚于精确时间一轮迭代的耗时
   int addTimer(int64_t microseconds,
                const Event::Handler& handler,
-               bool single_shot) const;
+               bool single_shot,
+               bool precise = false) const;
   void removeTimer(int timer_id) const;
+  // 迁移定时器，保留其下一次到期时间
+  void moveTimer(int timer_id, Thread const* thd) const;
 
   std::string name() const { return thd_name_; }
 
   void processEvents(int max_time) const;
 
+  // 在本线程的事件循环中执行task，可在任意线程调用
+  void post(const Task& task) const;
+  /**
+   * @brief
+   * 投递带截止时间的任务，deadline与Thread::now()同一时间基准。
+   * 每轮迭代中带截止时间的任务按最早截止时间优先执行，先于普通任务；
+   * 开始执行时已超过截止时间的任务被丢弃
+   */
+  void post(const Task& task, int64_t deadline) const;
+  DeadlineStats deadlineStats() const;
+
+  /**
+   * @brief
+   * 在本线程当前一轮迭代的检查阶段之后析构obj，同一轮的请求合并处理。
+   * 可在任意线程调用，嵌套的事件循环(processEvents)中不会执行析构
+   */
+  void deleteLater(Object* obj) const;
+
+  Status status() const;
+  /**
+   * @brief
+   * 等待事件循环退出，不负责回收线程
+   * @param timeout 毫秒，-1表示一直等待
+   * @return 事件循环是否已退出
+   */
+  bool wait(int timeout = -1);
+  // 退出前继续处理剩余事件的最长时间(ms)
+  void setDrainTimeout(int timeout);
+
+  /**
+   * @brief
+   * 注册事件循环阶段回调，在本线程中执行，可在任意线程调用。
+   * 用于在每轮迭代的边界合并写操作、批量上报等
+   * @return 回调id，用于removeHook
+   */
+  int addHook(Phase phase, const Task& hook) const;
+  /**
+   * @brief
+   * 注册空闲回调，只在一轮迭代没有任何就绪事件和任务时执行，
+   * 所有空闲回调每轮共享setIdleBudget设置的时间预算，超出后下一轮继续
+   */
+  int addIdle(const IdleTask& task) const;
+  void removeHook(int id) const;
+  // 每轮空闲回调的时间预算(us)
+  void setIdleBudget(int64_t microseconds);
+
+  // 事件循环的累计负载，可在任意线程读取
+  Poller::LoadStats load() const;
+  // 开启后记录每个事件的处理耗时，供负载均衡使用，返回之前的状态
+  bool setProfiling(bool on) const;
+
  protected:
   void threadMain();
+  // 执行一轮事件循环，有待执行的任务时不阻塞
+  void runOnce(int timeout) const;
+  std::size_t runTasks() const;
+  std::size_t runDeadlines() const;
+  std::size_t runDeletes() const;
+  // 仅在本线程中调用
+  void schedule(const Task& task, int64_t deadline, bool shed) const;
+  Event::Handler deferred(const Event::Handler& handler, int64_t budget) const;
+  void runHooks(Phase phase) const;
+  void runIdle() const;
+  // 退出前处理已就绪的事件和任务
+  void drain() const;
+  void setStatus(Status status);
 
-  std::mutex mtx_;
-  bool run_ = false GAURDED_BY(mtx_);
-  std::shared_ptr<Poller> poller_ GAURDED_BY(mtx_);
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::atomic<bool> run_ = false;
+  std::shared_ptr<Poller> poller_;
+
+  Status status_ GAURDED_BY(mtx_);
+  int drain_timeout_ = 100;
+
+  static constexpr int64_t kNoDeadline = INT64_MAX;
+  struct Scheduled {
+    Task task_;
+    int64_t deadline_;
+    bool shed_;  // 超过截止时间时是否丢弃
+  };
+  mutable utils::thread::list<Scheduled> tasks_;
+  // 按截止时间排列的最小堆，仅在本线程中访问
+  mutable std::vector<Scheduled> deadlines_;
+  mutable std::atomic<uint64_t> executed_ = 0;
+  mutable std::atomic<uint64_t> shed_ = 0;
+  mutable std::atomic<uint64_t> late_ = 0;
 
-  Status status_;
+  struct Deletion {
+    Object* obj_;
+    // 由shared_ptr持有的对象只释放该引用
+    std::shared_ptr<Object> keep_;
+  };
+  mutable utils::thread::list<Deletion> deletes_;
+  // runOnce的嵌套深度，仅在本线程中访问
+  mutable int depth_ = 0;
+  // 经过的静止点个数
+  mutable std::atomic<uint64_t> quiescent_ = 0;
+
+  struct Hooks {
+    std::vector<std::pair<int, Task>> prepare_;
+    std::vector<std::pair<int, Task>> check_;
+    std::vector<std::pair<int, IdleTask>> idle_;
+  };
+  // 写时复制，事件循环每轮只取一次快照
+  mutable std::mutex hook_mtx_;
+  mutable std::shared_ptr<const Hooks> hooks_ GAURDED_BY(hook_mtx_);
+  mutable int hook_id_ GAURDED_BY(hook_mtx_) = 0;
+  std::atomic<int64_t> idle_budget_ = 1000;
+  mutable bool idle_pending_ = false;
+  mutable std::size_t idle_cursor_ = 0;
 
+  // 串行化start()，回收上一次的线程时不持有mtx_
+  std::mutex start_mtx_;
   std::thread thd_;
   std::string thd_name_;
 };
@@ -66,10 +242,27 @@ class Thread {
 class MainThread;
 class Application {
  public:
+  using SignalHandler = std::function<void(int)>;
+
   static int exec();
-  static void exit();
+  /**
+   * @brief
+   * 发起有序退出，可在任意线程调用且不阻塞。
+   * 在主线程中依次执行退出回调、停止所有线程并等待其处理完剩余事件，
+   * 最后退出主循环，exec返回code
+   */
+  static void exit(int code = 0);
   static Thread* thread();
 
+  /**
+   * @brief
+   * 通过signalfd在主线程的事件循环中处理信号。
+   * 信号只在调用线程中被屏蔽，需在主线程中、启动其他线程之前订阅
+   */
+  static void onSignal(int signo, const SignalHandler& handler);
+  // 退出流程开始时在主线程中调用，用于停止接收新的请求
+  static void onQuit(const Thread::Task& hook);
+
  private:
   static Application& instance() {
     static Application inst;
@@ -79,7 +272,22 @@ class Application {
   Application();
   ~Application();
 
+  void shutdown();
+  void handleSignals();
+
   MainThread* thd_;
+
+  std::mutex mtx_;
+  std::map<int, std::vector<SignalHandler>> signal_handlers_ GAURDED_BY(mtx_);
+  std::vector<Thread::Task> quit_hooks_ GAURDED_BY(mtx_);
+  sigset_t mask_ GAURDED_BY(mtx_);
+  int signal_fd_ = -1;
+  std::optional<Trigger> signal_trigger_;
+
+  std::atomic<bool> quitting_ = false;
+  int code_ = 0;
+
+  friend class Thread;
 };
 
 }  // namespace core
\ No newline at end of file
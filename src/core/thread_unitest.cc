@@ -0,0 +1,435 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include "core/thread.h"
+
+namespace {
+
+class Tracked : public core::Object {
+ public:
+  explicit Tracked(std::atomic<int>& destroyed) : destroyed_(destroyed) {}
+  ~Tracked() override {
+    thd_ = core::Thread::this_thread();
+    ++destroyed_;
+  }
+
+  inline static std::atomic<core::Thread*> thd_ = nullptr;
+  std::atomic<int>& destroyed_;
+  std::optional<core::Trigger> trigger_;
+};
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 2000) {
+  for (int i = 0; i < timeout_ms; ++i) {
+    if (pred()) {
+      return true;
+    }
+    usleep(1000);
+  }
+  return pred();
+}
+
+}  // namespace
+
+TEST(Thread, MoveEvent) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+
+  std::atomic<core::Thread*> handled_by = nullptr;
+  std::atomic<int> hits = 0;
+  auto trigger = a.addEvent(core::Events::Execute, [&](const core::Event*) {
+    handled_by = core::Thread::this_thread();
+    ++hits;
+  });
+
+  trigger.trigger();
+  ASSERT_TRUE(waitFor([&]() { return hits == 1; }));
+  EXPECT_EQ(handled_by, &a);
+
+  // 迁移与触发之间不做任何等待，触发不能丢失
+  trigger.moveToThread(&b);
+  trigger.trigger();
+  ASSERT_TRUE(waitFor([&]() { return hits == 2; }));
+  EXPECT_EQ(handled_by, &b);
+
+  // 迁移途中再次迁移
+  trigger.moveToThread(&a);
+  trigger.moveToThread(&b);
+  trigger.trigger();
+  ASSERT_TRUE(waitFor([&]() { return hits == 3; }));
+  EXPECT_EQ(handled_by, &b);
+}
+
+TEST(Thread, MoveEvents) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+
+  constexpr int size = 64;
+  std::atomic<int> on_a = 0;
+  std::atomic<int> on_b = 0;
+  std::vector<core::Trigger> triggers;
+  triggers.reserve(size);
+  std::vector<int> fds;
+  for (int i = 0; i < size; ++i) {
+    triggers.emplace_back(
+        a.addEvent(core::Events::Execute, [&](const core::Event*) {
+          ++(core::Thread::this_thread() == &a ? on_a : on_b);
+        }));
+    fds.push_back(triggers.back().fd());
+  }
+  for (auto& t : triggers) {
+    t.trigger();
+  }
+  ASSERT_TRUE(waitFor([&]() { return on_a == size; }));
+
+  a.moveEvents(fds, &b);
+  for (auto& t : triggers) {
+    t.trigger();
+  }
+  ASSERT_TRUE(waitFor([&]() { return on_b == size; }));
+  EXPECT_EQ(on_a, size);
+}
+
+TEST(Thread, Post) {
+  core::Thread a("a");
+  a.start();
+
+  std::atomic<core::Thread*> run_by = nullptr;
+  a.post([&]() { run_by = core::Thread::this_thread(); });
+  ASSERT_TRUE(waitFor([&]() { return run_by == &a; }));
+
+  a.stop();
+  EXPECT_TRUE(a.wait(1000));
+  EXPECT_EQ(a.status(), core::Thread::Status::Exit);
+}
+
+TEST(Thread, Restart) {
+  core::Thread a("a");
+  for (int i = 0; i < 3; ++i) {
+    a.start();
+    std::atomic<bool> ran = false;
+    a.post([&]() { ran = true; });
+    ASSERT_TRUE(waitFor([&]() { return ran.load(); }));
+
+    a.stop();
+    EXPECT_TRUE(a.wait(1000));
+  }
+}
+
+TEST(Thread, DeleteLater) {
+  core::Thread a("a");
+  a.start();
+  std::atomic<int> destroyed = 0;
+
+  // 跨线程调用在所属线程中析构，重复调用只析构一次
+  auto obj = new Tracked(destroyed);
+  obj->moveToThread(&a);
+  obj->deleteLater();
+  obj->deleteLater();
+  ASSERT_TRUE(waitFor([&]() { return destroyed == 1; }));
+  EXPECT_EQ(Tracked::thd_, &a);
+
+  // 当前任务结束前不会析构
+  std::atomic<bool> alive = false;
+  a.post([&]() {
+    auto obj = new Tracked(destroyed);
+    obj->deleteLater();
+    core::Thread::this_thread()->processEvents(1);
+    alive = destroyed == 1;
+  });
+  ASSERT_TRUE(waitFor([&]() { return destroyed == 2; }));
+  EXPECT_TRUE(alive);
+
+  // 在自身的事件处理函数中销毁
+  std::atomic<Tracked*> self = nullptr;
+  a.post([&]() {
+    auto obj = new Tracked(destroyed);
+    obj->trigger_.emplace(core::Thread::this_thread()->addEvent(
+        core::Events::Execute, [obj](const core::Event*) {
+          obj->trigger_.reset();
+          obj->deleteLater();
+        }));
+    self = obj;
+  });
+  ASSERT_TRUE(waitFor([&]() { return self != nullptr; }));
+  a.post([&]() { self.load()->trigger_->trigger(); });
+  ASSERT_TRUE(waitFor([&]() { return destroyed == 3; }));
+
+  // 由shared_ptr持有的对象只释放事件循环的引用
+  auto shared = std::make_shared<Tracked>(destroyed);
+  shared->moveToThread(&a);
+  shared->deleteLater();
+  usleep(10000);
+  EXPECT_EQ(destroyed, 3);
+  shared.reset();
+  EXPECT_EQ(destroyed, 4);
+
+  a.stop();
+  a.wait();
+}
+
+TEST(Application, SignalExit) {
+  core::Thread a("a");
+  a.start();
+
+  // 退出时a上已就绪的事件仍会被处理，处理函数中可以创建线程
+  std::atomic<int> hits = 0;
+  auto trigger = a.addEvent(core::Events::Execute, [&](const core::Event*) {
+    core::Thread tmp("tmp");
+    ++hits;
+  });
+
+  bool quit_hook = false;
+  core::Application::onQuit([&]() {
+    quit_hook = true;
+    trigger.trigger();
+  });
+  core::Application::onSignal(SIGUSR1,
+                              [](int) { core::Application::exit(3); });
+  raise(SIGUSR1);
+
+  EXPECT_EQ(core::Application::exec(), 3);
+  EXPECT_TRUE(quit_hook);
+  EXPECT_EQ(a.status(), core::Thread::Status::Exit);
+  EXPECT_EQ(hits, 1);
+}
+
+TEST(Thread, Hooks) {
+  core::Thread a("a");
+
+  // 同一轮迭代中投递的写请求在check阶段合并为一次flush
+  std::vector<int> pending;
+  std::vector<std::size_t> flushed;
+  std::atomic<int> prepared = 0;
+  a.addHook(core::Thread::Phase::Prepare, [&]() { ++prepared; });
+  auto check = a.addHook(core::Thread::Phase::Check, [&]() {
+    if (!pending.empty()) {
+      flushed.push_back(pending.size());
+      pending.clear();
+    }
+  });
+  for (int i = 0; i < 10; ++i) {
+    a.post([&pending, i]() { pending.push_back(i); });
+  }
+
+  std::atomic<int> idle_runs = 0;
+  std::atomic<bool> idle_on_a = false;
+  a.addIdle([&]() {
+    idle_on_a = core::Thread::this_thread() == &a;
+    // 前几次返回true，事件循环不休眠继续调用
+    return ++idle_runs < 3;
+  });
+
+  a.start();
+  ASSERT_TRUE(waitFor([&]() { return idle_runs >= 3; }));
+  a.stop();
+  a.wait();
+
+  ASSERT_EQ(flushed.size(), 1u);
+  EXPECT_EQ(flushed[0], 10u);
+  EXPECT_GT(prepared, 0);
+  EXPECT_TRUE(idle_on_a);
+  // 空闲回调报告没有剩余工作后，事件循环进入休眠
+  EXPECT_EQ(idle_runs, 3);
+
+  a.removeHook(check);
+}
+
+TEST(Thread, TriggerCount) {
+  core::Thread a("a");
+  a.start();
+
+  std::atomic<int> calls = 0;
+  std::atomic<uint64_t> total = 0;
+  auto trigger = a.addEvent(core::Events::Execute, [&](const core::Event* ev) {
+    ++calls;
+    total += ev->count_;
+  });
+  trigger.trigger();
+  ASSERT_TRUE(waitFor([&]() { return calls == 1; }));
+
+  // 事件循环阻塞期间的触发合并为一次派发
+  std::atomic<bool> release = false;
+  a.post([&]() {
+    while (!release) {
+      usleep(100);
+    }
+  });
+  for (int i = 0; i < 5; ++i) {
+    trigger.trigger();
+  }
+  trigger.trigger(10);
+  release = true;
+
+  ASSERT_TRUE(waitFor([&]() { return total == 16; }));
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(Thread, LoopTime) {
+  core::Thread a("a");
+  a.start();
+
+  std::atomic<int64_t> first = 0;
+  std::atomic<int64_t> second = 0;
+  std::atomic<int64_t> precise = 0;
+  auto start = core::Thread::now(true);
+  a.addTimer(
+      5000,
+      [&](const core::Event*) {
+        first = core::Thread::now();
+        usleep(1000);
+        // 同一轮迭代内循环时间不变
+        second = core::Thread::now();
+        precise = core::Thread::now(true);
+      },
+      true);
+
+  ASSERT_TRUE(waitFor([&]() { return precise != 0; }));
+  EXPECT_EQ(first, second);
+  EXPECT_GE(precise - first, 1000);
+  EXPECT_GE(first - start, 5000);
+}
+
+TEST(Thread, LoopTimeWithoutLoop) {
+  // 没有运行事件循环的线程读到的时间随时间推进
+  auto before = core::Thread::now();
+  usleep(20000);
+  EXPECT_GE(core::Thread::now() - before, 20000);
+}
+
+TEST(Thread, DeadlineFromWorker) {
+  // 在没有事件循环的线程中以Thread::now()为基准投递，不会被误判为已过期
+  core::Thread a("a");
+  a.start();
+  std::atomic<bool> done = false;
+  std::thread worker([&]() {
+    a.post([&]() { done = true; }, core::Thread::now() + 100000);
+  });
+  worker.join();
+  ASSERT_TRUE(waitFor([&]() { return done.load(); }));
+  auto stats = a.deadlineStats();
+  EXPECT_EQ(stats.executed, 1u);
+  EXPECT_EQ(stats.shed, 0u);
+}
+
+
+TEST(Thread, Deadline) {
+  core::Thread a("a");
+  a.start();
+
+  std::atomic<bool> release = false;
+  a.post([&]() {
+    while (!release) {
+      usleep(100);
+    }
+  });
+
+  // 事件循环阻塞期间积压的任务按截止时间先后执行，已过期的被丢弃
+  std::vector<int> order;
+  std::atomic<bool> done = false;
+  auto now = core::Thread::now(true);
+  a.post([&]() { order.push_back(0); });
+  a.post([&]() { order.push_back(3); }, now + 3000000);
+  a.post([&]() { order.push_back(1); }, now + 1000000);
+  a.post([&]() { order.push_back(-1); }, now - 1);
+  a.post([&]() { order.push_back(2); }, now + 2000000);
+  a.post([&]() { done = true; });
+  release = true;
+
+  ASSERT_TRUE(waitFor([&]() { return done.load(); }));
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 0}));
+  auto stats = a.deadlineStats();
+  EXPECT_EQ(stats.executed, 3u);
+  EXPECT_EQ(stats.shed, 1u);
+  EXPECT_EQ(stats.late, 0u);
+
+  // 带处理时限的事件超时后仍会执行，计入late
+  std::atomic<int> hits = 0;
+  auto trigger = a.addEvent(
+      core::Events::Execute,
+      [&](const core::Event* ev) {
+        usleep(2000);
+        hits += ev->count_;
+      },
+      1000);
+  trigger.trigger(2);
+  ASSERT_TRUE(waitFor([&]() { return hits == 2; }));
+  ASSERT_TRUE(waitFor([&]() { return a.deadlineStats().late == 1; }));
+  EXPECT_EQ(a.deadlineStats().executed, 4u);
+}
+
+TEST(Thread, VirtualClock) {
+  core::setPollerType(core::PollerType::Virtual);
+  core::Thread a("a");
+  core::setPollerType(core::PollerType::Epoll);
+
+  // 一小时的秒级定时器在虚拟时钟下无需真实等待
+  constexpr int64_t second = 1000000;
+  std::atomic<int> fired = 0;
+  std::atomic<int64_t> last = 0;
+  std::atomic<int64_t> start = 0;
+  a.post([&]() { start = core::Thread::now(); });
+  auto id = a.addTimer(
+      second,
+      [&](const core::Event*) {
+        last = core::Thread::now();
+        ++fired;
+      },
+      false);
+
+  auto real = std::chrono::steady_clock::now();
+  a.start();
+  ASSERT_TRUE(waitFor([&]() { return fired >= 3600; }, 10000));
+  a.removeTimer(id);
+  a.stop();
+  a.wait();
+
+  EXPECT_LT(std::chrono::steady_clock::now() - real, std::chrono::seconds(5));
+  // 周期定时器按到期时间推进，没有漂移
+  EXPECT_EQ((last - start) % second, 0);
+  EXPECT_GE(last - start, 3600 * second);
+}
+
+TEST(Thread, Synchronize) {
+  core::Thread a("a");
+  core::Thread b("b");
+  a.start();
+  b.start();
+  ASSERT_TRUE(waitFor([&]() {
+    return a.status() == core::Thread::Status::Running &&
+           b.status() == core::Thread::Status::Running;
+  }));
+
+  // 空闲的线程被唤醒后立即经过静止点
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; ++i) {
+    core::Thread::synchronize();
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  // 处理函数阻塞超过复查间隔时，宽限期持续到其返回
+  std::atomic<bool> entered = false;
+  std::atomic<bool> done = false;
+  a.post([&]() {
+    entered = true;
+    usleep(300000);
+    done = true;
+  });
+  ASSERT_TRUE(waitFor([&]() { return entered.load(); }));
+  core::Thread::synchronize();
+  EXPECT_TRUE(done);
+
+  a.stop();
+  b.stop();
+  EXPECT_TRUE(a.wait(1000));
+  EXPECT_TRUE(b.wait(1000));
+}
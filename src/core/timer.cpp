@@ -46,8 +46,7 @@ int64_t Timer::interval() const {
 
 void Timer::moveToThread(Thread* thd) {
   if (timer_id_ > -1) {
-    thread()->removeTimer(timer_id_);
-    timer_id_ = thd->addTimer(interval_, handler_, false);
+    thread()->moveTimer(timer_id_, thd);
   }
   Object::moveToThread(thd);
 }
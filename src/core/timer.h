@@ -9,6 +9,8 @@
 namespace core {
 
 class Timer : public core::Object {
+  META_OBJECT(Timer, Object)
+
  public:
   Timer(const Event::Handler& handler, Object* parent = nullptr);
   ~Timer() override;
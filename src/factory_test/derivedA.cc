@@ -1 +1,3 @@
-#include "derivedA.h"
\ No newline at end of file
+#include "derivedA.h"
+
+LAZY_CLASS_REGISTER(Register<BaseFactory, DerivedA>)
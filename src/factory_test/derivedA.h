@@ -2,7 +2,7 @@
 
 #include "factory.h"
 
-class DerivedA : public Base, public BaseRegister<DerivedA> {
+class DerivedA : public Base {
  public:
   constexpr static char type[] = "A";
   static std::shared_ptr<Base> create() { return std::make_shared<DerivedA>(); }
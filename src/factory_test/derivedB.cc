@@ -1 +1,3 @@
-#include "derivedB.h"
\ No newline at end of file
+#include "derivedB.h"
+
+LAZY_CLASS_REGISTER(Register<BaseFactory, DerivedB>)
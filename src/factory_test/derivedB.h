@@ -2,7 +2,7 @@
 
 #include "factory.h"
 
-class DerivedB : public Base, public BaseRegister<DerivedB> {
+class DerivedB : public Base {
  public:
   constexpr static char type[] = "B";
   static std::shared_ptr<Base> create() { return std::make_shared<DerivedB>(); }
@@ -3,6 +3,7 @@
 #include "core/object.h"
 #include "utils/factory/class_factory.hpp"
 #include "utils/factory/class_register.hpp"
+#include "utils/factory/lazy_register.hpp"
 
 class Base : public core::Object {
  protected:
@@ -11,7 +12,3 @@ class Base : public core::Object {
 };
 
 using BaseFactory = FactorySingleTon<std::string, Base>;
-
-template <class Derived>
-using BaseRegister =
-    ClassRegister<Base, Derived, Register<BaseFactory, Derived>>;
\ No newline at end of file
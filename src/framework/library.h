@@ -1,6 +1,6 @@
 #pragma once
 
 #ifdef __unix__
-#include "core/unix/library.h"
+#include "core/library/library.h"
 #elif _WIN32
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,9 @@
+#include "framework/module.h"
+
+namespace core {
+
+void Module::setStatus(Status status) {
+  status_ = status;
+}
+
+}  // namespace core
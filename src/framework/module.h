@@ -1,22 +1,48 @@
 #pragma once
 
+#include <atomic>
+#include <string>
+
 #include "core/object.h"
+#include "utils/macros.hpp"
 
 namespace core {
 
 class Module : public Object {
+  META_OBJECT(Module, Object)
+
  public:
   enum class Status { OK = 0, Loading, Unready, Offline, Warnning, Error };
 
   Module() = default;
 
   virtual void initialize() = 0;
+  /**
+   * @brief
+   * 热更新时新版本接管旧版本的状态(如连接)。
+   * 在新版本发布且所有core::Thread经过静止点后调用，此时旧版本已不再被事件循环调用；
+   * 接管完成前新版本的状态为Loading
+   */
+  virtual void takeover(Module& previous) { UNUSED(previous); }
+
+  Status status() const { return status_; }
+  // 清单中的模块名，由ModuleLoader在initialize之前设置
+  const std::string& name() const { return name_; }
 
  protected:
   void setStatus(Status status);
 
  private:
-  Status status_;
+  std::atomic<Status> status_ = Status::Unready;
+  std::string name_;
+
+  friend class ModuleLoader;
 };
 
-}  // namespace core
\ No newline at end of file
+}  // namespace core
+
+// 模块动态库的入口，每个动态库导出一个
+#define EXPORT_MODULE(cls)                                   \
+  extern "C" core::Module* phoenix_create_module() {         \
+    return new cls;                                          \
+  }
@@ -0,0 +1,364 @@
+#include "framework/module_loader.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/library/library.h"
+#include "core/thread.h"
+#include "utils/thread/thread_pool.hpp"
+#include "utils/thread/wait.hpp"
+
+namespace core {
+
+namespace {
+
+// 模块动态库导出的入口
+constexpr char kEntry[] = "phoenix_create_module";
+
+int64_t clock() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+struct ModuleLoader::Entry {
+  std::string name_;
+  std::string path_;
+  std::vector<std::string> depends_;
+  std::vector<std::string> symbols_;
+
+  std::vector<Entry*> dependents_;
+  // 尚未初始化完成的依赖数
+  std::size_t waiting_ = 0;
+
+  std::unique_ptr<Library> lib_;
+  // 热更新时以原子操作替换
+  std::atomic<Module*> module_ = nullptr;
+  Timing timing_;
+  bool failed_ = false;
+};
+
+ModuleLoader::ModuleLoader(std::size_t threads)
+    : threads_(std::max<std::size_t>(threads, 1)) {}
+
+ModuleLoader::~ModuleLoader() {
+  // 下游模块先于其依赖析构，模块先于其动态库析构
+  for (auto iter = order_.rbegin(); iter != order_.rend(); ++iter) {
+    delete (*iter)->module_.exchange(nullptr);
+  }
+  entries_.clear();
+}
+
+bool ModuleLoader::load(const utils::Node& manifest) {
+  auto origin = clock();
+  error_.clear();
+
+  if (!manifest.hasMember("modules") || !manifest["modules"].isArray()) {
+    error_ = "manifest has no modules";
+    return false;
+  }
+
+  // 整个清单检查通过后才登记，出错时不留下部分模块
+  std::vector<std::unique_ptr<Entry>> parsed;
+  std::set<std::string> names;
+  auto const& modules = manifest["modules"];
+  for (std::size_t i = 0; i < modules.size(); ++i) {
+    auto const& m = modules[static_cast<int>(i)];
+    auto entry = std::make_unique<Entry>();
+    entry->name_ = m["name"].as<std::string>();
+    entry->path_ = m["path"].as<std::string>();
+    if (m.hasMember("depends")) {
+      entry->depends_ = m["depends"].as<std::vector<std::string>>();
+    }
+    if (m.hasMember("symbols")) {
+      entry->symbols_ = m["symbols"].as<std::vector<std::string>>();
+    }
+    entry->timing_.name = entry->name_;
+    if (entries_.count(entry->name_) == 1 ||
+        !names.insert(entry->name_).second) {
+      error_ = "duplicate module " + entry->name_;
+      return false;
+    }
+    parsed.push_back(std::move(entry));
+  }
+
+  std::vector<Entry*> added;
+  for (auto& entry : parsed) {
+    added.push_back(entry.get());
+    entries_.emplace(entry->name_, std::move(entry));
+  }
+
+  std::vector<Timing> failures;
+  auto fail = [&failures](Entry* e, const std::string& error) {
+    e->failed_ = true;
+    e->timing_.error = error;
+    failures.push_back(e->timing_);
+  };
+  // 依赖失败的模块及其下游均不加载，返回新标记的个数
+  std::function<std::size_t(Entry*)> skip = [&](Entry* e) {
+    std::size_t n = 0;
+    for (auto d : e->dependents_) {
+      if (!d->failed_) {
+        fail(d, "dependency " + e->name_ + " failed");
+        n += skip(d) + 1;
+      }
+    }
+    return n;
+  };
+
+  // 建图，已在之前的清单中加载的依赖视为已完成
+  for (auto e : added) {
+    for (auto const& dep : e->depends_) {
+      auto iter = entries_.find(dep);
+      if (iter == entries_.end()) {
+        fail(e, "missing dependency " + dep);
+        continue;
+      }
+      auto d = iter->second.get();
+      if (d->module_ || d->failed_) {
+        if (d->failed_) {
+          fail(e, "dependency " + dep + " failed");
+        }
+        continue;
+      }
+      d->dependents_.push_back(e);
+      ++e->waiting_;
+    }
+  }
+
+  // 拓扑排序预演，剩余的模块处于环中
+  {
+    std::map<Entry*, std::size_t> waiting;
+    std::vector<Entry*> ready;
+    for (auto e : added) {
+      waiting[e] = e->waiting_;
+      if (e->waiting_ == 0) {
+        ready.push_back(e);
+      }
+    }
+    while (!ready.empty()) {
+      auto e = ready.back();
+      ready.pop_back();
+      for (auto d : e->dependents_) {
+        if (--waiting[d] == 0) {
+          ready.push_back(d);
+        }
+      }
+    }
+    for (auto e : added) {
+      if (waiting[e] != 0 && !e->failed_) {
+        fail(e, "circular dependency");
+      }
+    }
+  }
+  for (std::size_t i = 0, n = failures.size(); i < n; ++i) {
+    skip(entries_[failures[i].name].get());
+  }
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::size_t done = 0;
+  utils::thread::ThreadPool pool(std::min(threads_, added.size()));
+
+  std::function<void(Entry*)> schedule;
+  auto finish = [&](Entry* e) {
+    {
+      std::scoped_lock lck(mtx);
+      ++done;
+      if (e->failed_) {
+        failures.push_back(e->timing_);
+        done += skip(e);
+      } else {
+        order_.push_back(e);
+        timings_.push_back(e->timing_);
+        for (auto d : e->dependents_) {
+          if (--d->waiting_ == 0 && !d->failed_) {
+            schedule(d);
+          }
+        }
+      }
+    }
+    cv.notify_all();
+  };
+  schedule = [&](Entry* e) {
+    pool.post([&, e]() {
+      loadOne(*e, origin);
+      finish(e);
+    });
+  };
+
+  {
+    std::scoped_lock lck(mtx);
+    for (auto e : added) {
+      if (e->failed_) {
+        ++done;
+      } else if (e->waiting_ == 0) {
+        schedule(e);
+      }
+    }
+  }
+
+  {
+    std::unique_lock lck(mtx);
+    utils::thread::wait(cv, lck, [&]() { return done == added.size(); });
+  }
+
+  // 失败的模块排在成功的之后
+  timings_.insert(timings_.end(), failures.begin(), failures.end());
+  elapsed_ = clock() - origin;
+  for (auto const& f : failures) {
+    error_ += (error_.empty() ? "" : "; ") + f.name + ": " + f.error;
+  }
+  return failures.empty();
+}
+
+void ModuleLoader::loadOne(Entry& entry, int64_t origin) {
+  auto& timing = entry.timing_;
+  auto begin = clock();
+  timing.begin_ns = begin - origin;
+
+  // 加载时完成全部重定位，模块的首次调用没有延迟绑定的开销
+  entry.lib_ = std::make_unique<Library>(entry.path_, Library::Binding::Now);
+  auto loaded = clock();
+  timing.load_ns = loaded - begin;
+  if (!entry.lib_->isLoaded()) {
+    entry.failed_ = true;
+    timing.error = entry.lib_->error();
+    timing.end_ns = loaded - origin;
+    return;
+  }
+
+  auto create = entry.lib_->resolve<Module*()>(kEntry);
+  auto declared = entry.lib_->declare(entry.symbols_);
+  auto resolved = clock();
+  timing.bind_ns = resolved - loaded;
+  if (!create || !declared) {
+    entry.failed_ = true;
+    timing.error = entry.lib_->error();
+    timing.end_ns = resolved - origin;
+    return;
+  }
+
+  // 在线程池中执行，异常只使本模块失败，依赖它的模块随之跳过
+  std::unique_ptr<Module> module;
+  try {
+    module.reset(create());
+    if (!module) {
+      throw std::runtime_error("module entry returned null");
+    }
+    module->name_ = entry.name_;
+    module->setStatus(Module::Status::Loading);
+    module->initialize();
+  } catch (const std::exception& e) {
+    entry.failed_ = true;
+    timing.error = e.what();
+  } catch (...) {
+    entry.failed_ = true;
+    timing.error = "unknown exception";
+  }
+  auto end = clock();
+  if (entry.failed_) {
+    timing.init_ns = end - resolved;
+    timing.end_ns = end - origin;
+    return;
+  }
+
+  if (module->status() == Module::Status::Loading) {
+    module->setStatus(Module::Status::OK);
+  }
+  entry.module_ = module.release();
+  timing.init_ns = end - resolved;
+  timing.end_ns = end - origin;
+  timing.ok = true;
+}
+
+bool ModuleLoader::reload(const std::string& name, const std::string& path) {
+  std::scoped_lock lck(reload_mtx_);
+  auto iter = entries_.find(name);
+  if (iter == entries_.end() || !iter->second->module_) {
+    error_ = "module " + name + " is not loaded";
+    return false;
+  }
+  auto& entry = *iter->second;
+
+  // 新版本与旧版本同时加载，失败时旧版本不受影响
+  auto origin = clock();
+  Entry next;
+  next.name_ = entry.name_;
+  next.path_ = path;
+  next.symbols_ = entry.symbols_;
+  next.timing_.name = entry.name_;
+  loadOne(next, origin);
+  if (next.failed_) {
+    error_ = name + ": " + next.timing_.error;
+    timings_.push_back(next.timing_);
+    return false;
+  }
+
+  auto module = next.module_.load();
+  auto status = module->status();
+  module->setStatus(Module::Status::Loading);
+  auto old = entry.module_.exchange(module, std::memory_order_acq_rel);
+  auto old_lib = std::move(entry.lib_);
+  entry.lib_ = std::move(next.lib_);
+  entry.path_ = path;
+
+  // 事件循环不再调用旧模块后才读取其状态
+  Thread::synchronize();
+  module->takeover(*old);
+  if (module->status() == Module::Status::Loading) {
+    module->setStatus(status);
+  }
+
+  // 旧模块的代码在旧动态库中，须先析构模块再卸载
+  delete old;
+  old_lib.reset();
+
+  next.timing_.end_ns = clock() - origin;
+  timings_.push_back(next.timing_);
+  return true;
+}
+
+const std::atomic<Module*>* ModuleLoader::slot(const std::string& name) const {
+  auto iter = entries_.find(name);
+  return iter == entries_.end() ? nullptr : &iter->second->module_;
+}
+
+Module* ModuleLoader::module(const std::string& name) const {
+  auto iter = entries_.find(name);
+  return iter == entries_.end() ? nullptr : iter->second->module_.load();
+}
+
+Library* ModuleLoader::library(const std::string& name) const {
+  auto iter = entries_.find(name);
+  return iter == entries_.end() ? nullptr : iter->second->lib_.get();
+}
+
+std::string ModuleLoader::report() const {
+  auto ms = [](int64_t ns) { return static_cast<double>(ns) / 1e6; };
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << std::left << std::setw(20) << "module" << std::right << std::setw(10)
+     << "load(ms)" << std::setw(10) << "bind(ms)" << std::setw(10)
+     << "init(ms)" << std::setw(11) << "begin(ms)" << std::setw(10)
+     << "end(ms)" << "  status" << std::endl;
+  for (auto const& t : timings_) {
+    os << std::left << std::setw(20) << t.name << std::right << std::setw(10)
+       << ms(t.load_ns) << std::setw(10) << ms(t.bind_ns) << std::setw(10)
+       << ms(t.init_ns) << std::setw(11) << ms(t.begin_ns) << std::setw(10)
+       << ms(t.end_ns) << "  " << (t.ok ? "ok" : t.error) << std::endl;
+  }
+  os << "total " << ms(elapsed_) << " ms" << std::endl;
+  return os.str();
+}
+
+}  // namespace core
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "framework/module.h"
+#include "utils/meta.hpp"
+#include "utils/noncopyable.hpp"
+
+namespace core {
+
+class Library;
+
+/**
+ * @brief
+ * 指向模块当前版本的句柄，热更新后自动指向新版本。
+ * 每次访问只是一次原子读取，没有锁；
+ * 在core::Thread的处理函数中取得的指针在该处理函数返回前始终有效
+ */
+template <typename T>
+class ModulePtr {
+ public:
+  ModulePtr() = default;
+  explicit ModulePtr(const std::atomic<Module*>* slot) : slot_(slot) {}
+
+  T* get() const {
+    return slot_ ? static_cast<T*>(slot_->load(std::memory_order_acquire))
+                 : nullptr;
+  }
+  T* operator->() const { return get(); }
+  explicit operator bool() const { return get() != nullptr; }
+
+ private:
+  const std::atomic<Module*>* slot_ = nullptr;
+};
+
+/**
+ * @brief
+ * 按清单并行加载模块。
+ * 清单中的依赖关系构成有向无环图，没有未完成依赖的模块在线程池中
+ * 同时dlopen并initialize，模块在其全部依赖初始化完成后才开始加载。
+ * 模块动态库须以EXPORT_MODULE导出入口。
+ *
+ * 清单格式(json/yaml经parser::Parser读取后传入):
+ * {
+ *   "modules": [
+ *     {"name": "log", "path": "liblog.so"},
+ *     {"name": "net", "path": "libnet.so", "depends": ["log"],
+ *      "symbols": ["net_send"]}
+ *   ]
+ * }
+ * symbols为加载时即解析的符号，之后通过library(name)->declare<Sig>取得缓存
+ * 函数指针的句柄；reload后旧库的句柄随旧库失效，须重新取得
+ *
+ * reload在事件循环不停止的情况下替换模块：新版本与旧版本同时加载，
+ * 初始化完成后以原子操作发布，所有core::Thread经过静止点后新版本接管旧版本，
+ * 再析构旧模块、卸载旧动态库。新版本须为不同路径的文件，同一路径dlopen会返回已加载的库。
+ * 需要热更新的模块须以-fno-gnu-unique编译，否则glibc不会卸载旧动态库
+ */
+class ModuleLoader : public noncopyable {
+ public:
+  // 各阶段耗时(ns)，begin/end为相对load调用开始的时间
+  struct Timing {
+    std::string name;
+    int64_t load_ns = 0;      // dlopen: 映射、重定位与静态初始化
+    int64_t bind_ns = 0;      // dlsym: 入口与声明符号的查找
+    int64_t init_ns = 0;      // 构造模块并执行initialize
+    int64_t begin_ns = 0;
+    int64_t end_ns = 0;
+    bool ok = false;
+    std::string error;
+  };
+
+  explicit ModuleLoader(
+      std::size_t threads = std::thread::hardware_concurrency());
+  // 按依赖的逆序析构模块并卸载动态库
+  ~ModuleLoader();
+
+  /**
+   * @brief
+   * 加载清单中的全部模块，返回前全部完成。
+   * 依赖缺失、存在环或加载失败的模块及其下游均不加载
+   * @return 是否全部加载成功
+   */
+  bool load(const utils::Node& manifest);
+
+  /**
+   * @brief
+   * 加载path替换已加载的模块name，返回前旧版本已卸载。
+   * 新版本加载失败时保留旧版本
+   */
+  bool reload(const std::string& name, const std::string& path);
+
+  // 当前版本，热更新后失效，长期持有应使用get
+  Module* module(const std::string& name) const;
+  Library* library(const std::string& name) const;
+
+  template <typename T = Module>
+  ModulePtr<T> get(const std::string& name) const {
+    return ModulePtr<T>(slot(name));
+  }
+
+  // 按完成顺序排列
+  const std::vector<Timing>& timings() const { return timings_; }
+  // 总耗时(ns)
+  int64_t elapsed() const { return elapsed_; }
+  // 各模块耗时的文本报表
+  std::string report() const;
+
+  std::string error() const { return error_; }
+
+ private:
+  struct Entry;
+
+  void loadOne(Entry& entry, int64_t origin);
+  const std::atomic<Module*>* slot(const std::string& name) const;
+
+  std::size_t threads_;
+  std::map<std::string, std::unique_ptr<Entry>> entries_;
+  // 初始化完成的顺序，析构时逆序释放
+  std::vector<Entry*> order_;
+  std::vector<Timing> timings_;
+  int64_t elapsed_ = 0;
+  std::string error_;
+  std::mutex reload_mtx_;
+};
+
+}  // namespace core
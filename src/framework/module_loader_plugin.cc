@@ -0,0 +1,37 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "framework/module_loader_plugin.h"
+
+#ifndef PLUGIN_VERSION
+#define PLUGIN_VERSION 1
+#endif
+
+// 初始化耗时约20ms，名为throwing时初始化抛出异常
+class SleepModule : public TestModule {
+ public:
+  void initialize() override {
+    usleep(20000);
+    if (name() == "throwing") {
+      throw std::runtime_error("initialize failed");
+    }
+  }
+  void takeover(core::Module& previous) override {
+    generation_ = static_cast<TestModule&>(previous).generation() + 1;
+  }
+
+  int version() const override { return PLUGIN_VERSION; }
+  int generation() const override { return generation_; }
+
+ private:
+  // 接管在新版本发布后进行，事件循环可能同时读取
+  std::atomic<int> generation_ = 0;
+};
+
+extern "C" int module_loader_plugin_symbol() {
+  return PLUGIN_VERSION;
+}
+
+EXPORT_MODULE(SleepModule)
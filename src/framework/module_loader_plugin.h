@@ -0,0 +1,13 @@
+#pragma once
+
+#include "framework/module.h"
+
+// ModuleLoader单元测试加载的模块接口
+class TestModule : public core::Module {
+  META_OBJECT(TestModule, core::Module)
+
+ public:
+  virtual int version() const = 0;
+  // 已接管的旧版本个数
+  virtual int generation() const = 0;
+};
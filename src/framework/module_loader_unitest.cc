@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+#include "core/library/library.h"
+#include "core/thread.h"
+#include "framework/module_loader.h"
+#include "framework/module_loader_plugin.h"
+#include "parser/parser.h"
+
+namespace {
+
+std::string manifest(const std::string& modules) {
+  return "{\"modules\": [" + modules + "]}";
+}
+
+std::string module(const std::string& name,
+                   const std::string& depends = "",
+                   const std::string& path = MODULE_PLUGIN) {
+  return "{\"name\": \"" + name + "\", \"path\": \"" + path +
+         "\", \"depends\": [" + depends + "]}";
+}
+
+const core::ModuleLoader::Timing& timing(const core::ModuleLoader& loader,
+                                         const std::string& name) {
+  auto const& timings = loader.timings();
+  return *std::find_if(
+      timings.begin(), timings.end(),
+      [&name](const core::ModuleLoader::Timing& t) { return t.name == name; });
+}
+
+}  // namespace
+
+TEST(ModuleLoader, Parallel) {
+  // a-d互不依赖，e依赖全部
+  auto json = manifest(module("a") + "," + module("b") + "," + module("c") +
+                       "," + module("d") + "," +
+                       module("e", R"("a", "b", "c", "d")"));
+  core::ModuleLoader loader(4);
+  ASSERT_TRUE(loader.load(parser::Parser::deserialize("json", json)))
+      << loader.error();
+  std::cout << loader.report();
+
+  ASSERT_EQ(loader.timings().size(), 5u);
+  auto e = loader.module("e");
+  ASSERT_NE(e, nullptr);
+  // 插件以RTLD_LOCAL与-fno-gnu-unique加载，类型信息是另一份
+  EXPECT_NE(core::object_cast<TestModule>(e), nullptr);
+  EXPECT_EQ(e->name(), "e");
+  EXPECT_EQ(e->status(), core::Module::Status::OK);
+
+  auto const& last = timing(loader, "e");
+  for (auto name : {"a", "b", "c", "d"}) {
+    EXPECT_GE(last.begin_ns, timing(loader, name).end_ns);
+  }
+  // 每个模块初始化约20ms，串行时至少100ms
+  EXPECT_LT(loader.elapsed(), 90 * 1000000);
+
+  // 声明的符号在加载时解析
+  EXPECT_NE(loader.library("a")->resolve("module_loader_plugin_symbol"),
+            nullptr);
+}
+
+TEST(ModuleLoader, Failure) {
+  auto json = manifest(module("a") + "," + module("b", R"("a")", "none.so") +
+                       "," + module("c", R"("b")") + "," +
+                       module("d", R"("missing")") + "," +
+                       module("e", R"("f")") + "," + module("f", R"("e")"));
+  core::ModuleLoader loader(4);
+  EXPECT_FALSE(loader.load(parser::Parser::deserialize("json", json)));
+  std::cout << loader.report();
+
+  EXPECT_NE(loader.module("a"), nullptr);
+  for (auto name : {"b", "c", "d", "e", "f"}) {
+    EXPECT_EQ(loader.module(name), nullptr);
+    EXPECT_FALSE(timing(loader, name).ok);
+  }
+  EXPECT_EQ(timing(loader, "c").error, "dependency b failed");
+  EXPECT_EQ(timing(loader, "d").error, "missing dependency missing");
+  EXPECT_EQ(timing(loader, "e").error, "circular dependency");
+
+  // 初始化抛出异常只使该模块及其下游失败
+  auto throwing = manifest(module("throwing") + "," +
+                           module("after", R"("throwing")") + "," +
+                           module("sibling"));
+  EXPECT_FALSE(loader.load(parser::Parser::deserialize("json", throwing)));
+  EXPECT_EQ(timing(loader, "throwing").error, "initialize failed");
+  EXPECT_EQ(timing(loader, "after").error, "dependency throwing failed");
+  EXPECT_EQ(loader.module("throwing"), nullptr);
+  EXPECT_NE(loader.module("sibling"), nullptr);
+
+  // 名称重复时整个清单都不登记
+  auto dup = manifest(module("g") + "," + module("a"));
+  EXPECT_FALSE(loader.load(parser::Parser::deserialize("json", dup)));
+  EXPECT_EQ(loader.error(), "duplicate module a");
+  EXPECT_EQ(loader.module("g"), nullptr);
+  dup = manifest(module("g") + "," + module("g"));
+  EXPECT_FALSE(loader.load(parser::Parser::deserialize("json", dup)));
+  ASSERT_TRUE(loader.load(parser::Parser::deserialize("json",
+                                                      manifest(module("g")))))
+      << loader.error();
+  EXPECT_NE(loader.module("g"), nullptr);
+}
+
+TEST(ModuleLoader, Reload) {
+  core::ModuleLoader loader(1);
+  ASSERT_TRUE(
+      loader.load(parser::Parser::deserialize("json", manifest(module("a")))));
+  auto ptr = loader.get<TestModule>("a");
+  ASSERT_TRUE(ptr);
+  EXPECT_EQ(ptr->version(), 1);
+
+  // 事件循环持续调用模块，替换过程中不停止
+  core::Thread thd("reader");
+  thd.start();
+  std::atomic<int> seen = 0;
+  std::atomic<bool> torn = false;
+  std::atomic<bool> early = false;
+  thd.addTimer(
+      100,
+      [&](const core::Event*) {
+        auto m = ptr.get();
+        auto v = m->version();
+        torn = torn || (v != 1 && v != 2);
+        // 新版本在接管完成前为Loading
+        if (v == 2 && m->status() != core::Module::Status::Loading) {
+          early = early || m->generation() != 1;
+        }
+        seen = v;
+      },
+      false);
+  for (int i = 0; i < 1000 && seen != 1; ++i) {
+    usleep(1000);
+  }
+  ASSERT_EQ(seen, 1);
+
+  ASSERT_TRUE(loader.reload("a", MODULE_PLUGIN_V2)) << loader.error();
+  EXPECT_EQ(ptr->version(), 2);
+  EXPECT_EQ(ptr->generation(), 1);
+  EXPECT_EQ(ptr.get(), loader.module("a"));
+  for (int i = 0; i < 1000 && seen != 2; ++i) {
+    usleep(1000);
+  }
+  EXPECT_EQ(seen, 2);
+  EXPECT_FALSE(torn);
+  EXPECT_FALSE(early);
+  EXPECT_EQ(ptr->status(), core::Module::Status::OK);
+
+  // 旧版本已卸载
+  auto handle = dlopen(MODULE_PLUGIN, RTLD_NOW | RTLD_NOLOAD);
+  EXPECT_EQ(handle, nullptr);
+  if (handle) {
+    dlclose(handle);
+  }
+
+  // 加载失败时保留当前版本
+  EXPECT_FALSE(loader.reload("a", "none.so"));
+  EXPECT_EQ(ptr->version(), 2);
+  EXPECT_FALSE(loader.reload("b", MODULE_PLUGIN_V2));
+
+  thd.stop();
+  thd.wait();
+}
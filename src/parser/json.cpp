@@ -1,67 +1,400 @@
 #include "parser/json.h"
 
-#include <nlohmann/json.hpp>
-
-#include <fstream>
-#include <sstream>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
 
+#include "parser/json_index.h"
+#include "parser/json_writer.h"
 #include "parser/parser.h"
 
 namespace parser {
 
-static utils::Node deserialize(nlohmann::json j) {
-  utils::Node n;
-  if (j.is_object()) {
-    for (nlohmann::json::iterator it = j.begin(); it != j.end(); ++it) {
-      n[it.key()] = deserialize(it.value());
-    }
-  } else if (j.is_array()) {
-    for (nlohmann::json::iterator it = j.begin(); it != j.end(); ++it) {
-      n.push_back(deserialize(*it));
-    }
-  } else if (j.is_boolean()) {
-    n = j.get<bool>();
-  } else if (j.is_number_integer()) {
-    n = j.get<int>();
-  } else if (j.is_number_float()) {
-    n = j.get<double>();
-  } else if (j.is_string()) {
-    n = j.get<std::string>();
-  }
-  return n;
+namespace {
+
+std::atomic<Json::Backend> g_backend = Json::Backend::Auto;
+
+constexpr int kMaxDepth = 1024;
+
+// 第二阶段：沿结构字符索引递归下降，直接构造utils::Node
+class Builder {
+ public:
+  Builder(std::string_view bytes, const std::vector<uint32_t>& positions)
+      : data_(bytes.data()),
+        size_(bytes.size()),
+        idx_(positions.data()),
+        count_(positions.size()) {}
+
+  utils::Node parse() {
+    auto n = value(0);
+    skipSpace();
+    if (pos_ != size_ || cur_ != count_) {
+      fail("unexpected trailing content");
+    }
+    return n;
+  }
+
+ private:
+  [[noreturn]] void fail(const char* what) const {
+    throw std::invalid_argument(std::string("json: ") + what + " at offset " +
+                                std::to_string(pos_));
+  }
+
+  void skipSpace() {
+    while (pos_ < size_) {
+      auto c = data_[pos_];
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        break;
+      }
+      ++pos_;
+    }
+  }
+
+  // 跳过空白后当前位置须为下一个结构字符
+  char next() {
+    skipSpace();
+    if (cur_ == count_ || idx_[cur_] != pos_) {
+      fail("unexpected character");
+    }
+    ++cur_;
+    return data_[pos_++];
+  }
+
+  // 下一个结构字符为c时消费它
+  bool peek(char c) {
+    skipSpace();
+    if (cur_ != count_ && idx_[cur_] == pos_ && data_[pos_] == c) {
+      ++cur_;
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  utils::Node value(int depth) {
+    if (depth > kMaxDepth) {
+      fail("nesting too deep");
+    }
+    skipSpace();
+    if (pos_ == size_) {
+      fail("unexpected end of input");
+    }
+    if (cur_ == count_ || idx_[cur_] != pos_) {
+      return scalar();
+    }
+
+    switch (next()) {
+      case '"':
+        return utils::Node(string());
+      case '{':
+        return object(depth);
+      case '[':
+        return array(depth);
+      default:
+        --pos_;
+        fail("unexpected character");
+    }
+  }
+
+  utils::Node object(int depth) {
+    auto n = utils::Node::makeMap();
+    if (peek('}')) {
+      return n;
+    }
+    do {
+      if (next() != '"') {
+        fail("expected string key");
+      }
+      auto key = string();
+      if (next() != ':') {
+        fail("expected ':'");
+      }
+      n[key] = value(depth + 1);
+    } while (peek(','));
+    if (next() != '}') {
+      fail("expected ',' or '}'");
+    }
+    return n;
+  }
+
+  utils::Node array(int depth) {
+    auto n = utils::Node::makeArray();
+    if (peek(']')) {
+      return n;
+    }
+    do {
+      n.push_back(value(depth + 1));
+    } while (peek(','));
+    if (next() != ']') {
+      fail("expected ',' or ']'");
+    }
+    return n;
+  }
+
+  // 起始引号已消费，结束引号为下一个索引
+  std::string string() {
+    if (cur_ == count_) {
+      fail("unterminated string");
+    }
+    auto end = idx_[cur_++];
+    auto begin = data_ + pos_;
+    auto len = end - pos_;
+    pos_ = end + 1;
+    if (!std::memchr(begin, '\\', len)) {
+      return std::string(begin, len);
+    }
+    return unescape(begin, begin + len);
+  }
+
+  std::string unescape(const char* p, const char* end) {
+    std::string ret;
+    ret.reserve(end - p);
+    while (p < end) {
+      auto slash = static_cast<const char*>(std::memchr(p, '\\', end - p));
+      if (!slash) {
+        ret.append(p, end);
+        break;
+      }
+      ret.append(p, slash);
+      p = slash + 1;
+      switch (*p++) {
+        case '"':
+          ret += '"';
+          break;
+        case '\\':
+          ret += '\\';
+          break;
+        case '/':
+          ret += '/';
+          break;
+        case 'b':
+          ret += '\b';
+          break;
+        case 'f':
+          ret += '\f';
+          break;
+        case 'n':
+          ret += '\n';
+          break;
+        case 'r':
+          ret += '\r';
+          break;
+        case 't':
+          ret += '\t';
+          break;
+        case 'u': {
+          auto cp = hex4(p, end);
+          p += 4;
+          if (cp >= 0xd800 && cp <= 0xdbff) {
+            if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+              fail("unpaired surrogate");
+            }
+            auto low = hex4(p + 2, end);
+            if (low < 0xdc00 || low > 0xdfff) {
+              fail("unpaired surrogate");
+            }
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+            p += 6;
+          } else if (cp >= 0xdc00 && cp <= 0xdfff) {
+            fail("unpaired surrogate");
+          }
+          utf8(cp, ret);
+        } break;
+        default:
+          fail("invalid escape");
+      }
+    }
+    return ret;
+  }
+
+  uint32_t hex4(const char* p, const char* end) {
+    if (end - p < 4) {
+      fail("invalid \\u escape");
+    }
+    uint32_t cp = 0;
+    for (int i = 0; i < 4; ++i) {
+      auto c = p[i];
+      cp <<= 4;
+      if (c >= '0' && c <= '9') {
+        cp |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        cp |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        cp |= c - 'A' + 10;
+      } else {
+        fail("invalid \\u escape");
+      }
+    }
+    return cp;
+  }
+
+  static void utf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+      out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out += static_cast<char>(0xc0 | (cp >> 6));
+      out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+      out += static_cast<char>(0xe0 | (cp >> 12));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+      out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+      out += static_cast<char>(0xf0 | (cp >> 18));
+      out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+      out += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+  }
+
+  // 数值与true/false/null，之后只能是空白、结构字符或输入结束
+  utils::Node scalar() {
+    auto p = data_ + pos_;
+    auto end = cur_ == count_ ? data_ + size_ : data_ + idx_[cur_];
+    utils::Node n;
+    if (literal(p, end, "true")) {
+      n = true;
+    } else if (literal(p, end, "false")) {
+      n = false;
+    } else if (literal(p, end, "null")) {
+    } else {
+      n = number(p, end);
+    }
+    skipSpace();
+    if (pos_ != static_cast<std::size_t>(end - data_)) {
+      fail("unexpected character");
+    }
+    return n;
+  }
+
+  bool literal(const char* p, const char* end, std::string_view word) {
+    if (static_cast<std::size_t>(end - p) < word.size() ||
+        std::memcmp(p, word.data(), word.size()) != 0) {
+      return false;
+    }
+    pos_ += word.size();
+    return true;
+  }
+
+  utils::Node number(const char* p, const char* end) {
+    auto begin = p;
+    bool negative = p < end && *p == '-';
+    p += negative;
+    if (p == end || *p < '0' || *p > '9') {
+      fail("invalid literal");
+    }
+
+    // 整数部分，溢出时按浮点处理
+    uint64_t val = 0;
+    bool overflow = false;
+    auto digits = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      overflow |= __builtin_mul_overflow(val, 10, &val) ||
+                  __builtin_add_overflow(val, *p - '0', &val);
+      ++p;
+    }
+    if (*digits == '0' && p - digits > 1) {
+      fail("leading zero");
+    }
+
+    bool integral = true;
+    if (p < end && *p == '.') {
+      integral = false;
+      if (++p == end || *p < '0' || *p > '9') {
+        fail("invalid number");
+      }
+      while (p < end && *p >= '0' && *p <= '9') {
+        ++p;
+      }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      integral = false;
+      ++p;
+      if (p < end && (*p == '+' || *p == '-')) {
+        ++p;
+      }
+      if (p == end || *p < '0' || *p > '9') {
+        fail("invalid number");
+      }
+      while (p < end && *p >= '0' && *p <= '9') {
+        ++p;
+      }
+    }
+    pos_ += p - begin;
+
+    if (integral && !overflow) {
+      if (!negative) {
+        return utils::Node(val);
+      }
+      if (val <= static_cast<uint64_t>(INT64_MAX) + 1) {
+        return utils::Node(static_cast<int64_t>(0 - val));
+      }
+    }
+    double d;
+    auto [ptr, ec] = std::from_chars(begin, p, d);
+    if (ec != std::errc() || ptr != p) {
+      fail("number out of range");
+    }
+    return utils::Node(d);
+  }
+
+  const char* data_;
+  std::size_t size_;
+  const uint32_t* idx_;
+  std::size_t count_;
+  std::size_t pos_ = 0;
+  std::size_t cur_ = 0;
+};
+
+detail::Isa isaOf(Json::Backend backend) {
+  switch (backend) {
+    case Json::Backend::Avx2:
+      return detail::Isa::Avx2;
+    case Json::Backend::Sse42:
+      return detail::Isa::Sse42;
+    default:
+      return detail::Isa::Scalar;
+  }
 }
 
-utils::Node Json::deserialize(const std::string& bytes) {
-  auto j = nlohmann::json::parse(bytes);
-  return ::parser::deserialize(j);
+}  // namespace
+
+void Json::setBackend(Backend backend) {
+  g_backend = backend;
 }
 
-static nlohmann::json serialize(const utils::Node& node) {
-  nlohmann::json j;
-  if (node.isMap()) {
-    for (auto iter = node.begin(); iter != node.end(); ++iter) {
-      j[iter->first] = serialize(iter->second);
-    }
-  } else if (node.isArray()) {
-    for (auto iter = node.begin(); iter != node.end(); ++iter) {
-      j.push_back(serialize(*iter));
-    }
-  } else if (node.isBool()) {
-    j = node.as<bool>();
-  } else if (node.isInteger()) {
-    j = node.as<int>();
-  } else if (node.isDouble()) {
-    j = node.as<double>();
-  } else if (node.isString()) {
-    j = node.as<std::string>();
-  }
-  return j;
+Json::Backend Json::backend() {
+  auto backend = g_backend.load();
+  if (backend == Backend::Auto || !detail::supported(isaOf(backend))) {
+    switch (detail::detectIsa()) {
+      case detail::Isa::Avx2:
+        return Backend::Avx2;
+      case detail::Isa::Sse42:
+        return Backend::Sse42;
+      default:
+        return Backend::Scalar;
+    }
+  }
+  return backend;
+}
+
+utils::Node Json::deserialize(std::string_view bytes) {
+  if (bytes.size() > detail::kMaxSize) {
+    throw std::length_error("json: document exceeds 4GB");
+  }
+  std::vector<uint32_t> positions;
+  if (!detail::buildIndex(bytes, positions, isaOf(backend()))) {
+    throw std::invalid_argument(
+        "json: unterminated string, control character in string or invalid "
+        "UTF-8");
+  }
+  return Builder(bytes, positions).parse();
 }
 
 std::string Json::serialize(const utils::Node& node) {
-  std::stringstream sstm;
-  sstm << ::parser::serialize(node);
-  return sstm.str();
+  std::string out;
+  JsonWriter().write(node, out);
+  return out;
 }
 
 REGIST_PARSER(Json)
@@ -5,12 +5,33 @@
 
 namespace parser {
 
+/**
+ * @brief
+ * JSON解析分两个阶段：先以SIMD每次64字节找出结构字符与字符串边界，
+ * 同时检查UTF-8与字符串中的控制字符；再沿索引直接构造utils::Node。
+ * 超出int64的正整数保存为uint64，超出uint64的整数按浮点保存。
+ */
 class Json {
  public:
+  enum class Backend {
+    Auto,
+    Avx2,
+    Sse42,
+    Scalar,
+  };
+
   Json() = default;
 
+  /**
+   * @brief
+   * 指定第一阶段的实现。
+   * Auto及CPU不支持的指令集均使用当前CPU支持的最快实现
+   */
+  static void setBackend(Backend backend);
+  static Backend backend();
+
   constexpr static char key[] = "json";
-  static utils::Node deserialize(const std::string&);
+  static utils::Node deserialize(std::string_view);
   static std::string serialize(const utils::Node&);
 };
 
@@ -0,0 +1,496 @@
+#include "parser/json_index.h"
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace parser::detail {
+
+namespace {
+
+// 一个64字节块中各类字符的位图，第i位对应第i个字节
+struct Masks {
+  uint64_t backslash_;
+  uint64_t quote_;
+  uint64_t op_;
+  uint64_t ctrl_;
+  uint64_t high_;
+};
+
+enum : uint8_t {
+  kBackslash = 1,
+  kQuote = 2,
+  kOp = 4,
+  kCtrl = 8,
+  kHigh = 16,
+};
+
+struct Table {
+  constexpr Table() : cls_() {
+    for (int c = 0; c < 0x20; ++c) {
+      cls_[c] = kCtrl;
+    }
+    for (int c = 0x80; c < 0x100; ++c) {
+      cls_[c] = kHigh;
+    }
+    cls_[static_cast<uint8_t>('\\')] = kBackslash;
+    cls_[static_cast<uint8_t>('"')] = kQuote;
+    for (auto c : {'{', '}', '[', ']', ':', ','}) {
+      cls_[static_cast<uint8_t>(c)] = kOp;
+    }
+  }
+  uint8_t cls_[256];
+};
+
+constexpr Table kTable;
+
+void scalarMasks(const uint8_t* p, Masks& m) {
+  m = Masks{};
+  for (int i = 0; i < 64; ++i) {
+    uint64_t bit = 1ull << i;
+    auto cls = kTable.cls_[p[i]];
+    m.backslash_ |= (cls & kBackslash) ? bit : 0;
+    m.quote_ |= (cls & kQuote) ? bit : 0;
+    m.op_ |= (cls & kOp) ? bit : 0;
+    m.ctrl_ |= (cls & kCtrl) ? bit : 0;
+    m.high_ |= (cls & kHigh) ? bit : 0;
+  }
+}
+
+// '['与'{'、']'与'}'只相差0x20，或上0x20后各用一次比较
+__attribute__((target("sse4.2"))) void sse42Masks(const uint8_t* p,
+                                                   Masks& m) {
+  m = Masks{};
+  const auto backslash = _mm_set1_epi8('\\');
+  const auto quote = _mm_set1_epi8('"');
+  const auto open = _mm_set1_epi8('{');
+  const auto close = _mm_set1_epi8('}');
+  const auto colon = _mm_set1_epi8(':');
+  const auto comma = _mm_set1_epi8(',');
+  const auto lower = _mm_set1_epi8(0x20);
+  const auto ctrl = _mm_set1_epi8(0x1f);
+  for (int i = 0; i < 4; ++i) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+    auto folded = _mm_or_si128(v, lower);
+    auto op = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                     _mm_cmpeq_epi8(folded, close)),
+        _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+    auto shift = 16 * i;
+    m.backslash_ |=
+        static_cast<uint64_t>(static_cast<uint16_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash))))
+        << shift;
+    m.quote_ |= static_cast<uint64_t>(static_cast<uint16_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))))
+                << shift;
+    m.op_ |= static_cast<uint64_t>(
+                 static_cast<uint16_t>(_mm_movemask_epi8(op)))
+             << shift;
+    m.ctrl_ |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(
+                   _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl))))
+               << shift;
+    m.high_ |= static_cast<uint64_t>(
+                   static_cast<uint16_t>(_mm_movemask_epi8(v)))
+               << shift;
+  }
+}
+
+__attribute__((target("avx2"))) void avx2Masks(const uint8_t* p, Masks& m) {
+  m = Masks{};
+  const auto backslash = _mm256_set1_epi8('\\');
+  const auto quote = _mm256_set1_epi8('"');
+  const auto open = _mm256_set1_epi8('{');
+  const auto close = _mm256_set1_epi8('}');
+  const auto colon = _mm256_set1_epi8(':');
+  const auto comma = _mm256_set1_epi8(',');
+  const auto lower = _mm256_set1_epi8(0x20);
+  const auto ctrl = _mm256_set1_epi8(0x1f);
+  for (int i = 0; i < 2; ++i) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+    auto folded = _mm256_or_si256(v, lower);
+    auto op = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(folded, open),
+                        _mm256_cmpeq_epi8(folded, close)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, colon),
+                        _mm256_cmpeq_epi8(v, comma)));
+    auto shift = 32 * i;
+    m.backslash_ |= static_cast<uint64_t>(static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash))))
+                    << shift;
+    m.quote_ |= static_cast<uint64_t>(static_cast<uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote))))
+                << shift;
+    m.op_ |= static_cast<uint64_t>(
+                 static_cast<uint32_t>(_mm256_movemask_epi8(op)))
+             << shift;
+    m.ctrl_ |= static_cast<uint64_t>(
+                   static_cast<uint32_t>(_mm256_movemask_epi8(
+                       _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl))))
+               << shift;
+    m.high_ |= static_cast<uint64_t>(
+                   static_cast<uint32_t>(_mm256_movemask_epi8(v)))
+               << shift;
+  }
+}
+
+// UTF-8检查采用Keiser与Lemire的查表法：以前一字节的高4位、低4位与当前字节
+// 的高4位各查一次表，三者相与后非零的位即为错误；第三、四个字节是否应为
+// 续字节另由前两、三个字节判断，与表中的kTwoConts相抵
+constexpr uint8_t kTooShort = 1 << 0;    // 11______ 0_______
+constexpr uint8_t kTooLong = 1 << 1;     // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;   // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;    // 11110100 1001____
+constexpr uint8_t kSurrogate = 1 << 4;   // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;   // 1100000_ 10______
+constexpr uint8_t kOverlong4 = 1 << 6;   // 11110000 1000____
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101 1000____
+constexpr uint8_t kTwoConts = 1 << 7;    // 10______ 10______
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) constexpr uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTooLong, kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2, kTooShort, kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+alignas(16) constexpr uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+alignas(16) constexpr uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+// 减去后非零说明末尾的多字节字符未完成
+alignas(32) constexpr uint8_t kIncomplete[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+};
+
+// 以idx每字节的低4位查16项的表
+__attribute__((target("sse4.2"))) __m128i lookup(const uint8_t* table,
+                                                 __m128i idx) {
+  return _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(table)),
+      _mm_and_si128(idx, _mm_set1_epi8(0x0f)));
+}
+
+__attribute__((target("avx2"))) __m256i lookup(const uint8_t* table,
+                                               __m256i idx) {
+  return _mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(
+          _mm_load_si128(reinterpret_cast<const __m128i*>(table))),
+      _mm256_and_si256(idx, _mm256_set1_epi8(0x0f)));
+}
+
+// 标量实现记录第一个含非ASCII字节的块，扫描结束后从该处逐字节检查
+struct ScalarUtf8 {
+  void block(const uint8_t*, std::size_t off, uint64_t high) {
+    if (high && first_high_ == SIZE_MAX) {
+      first_high_ = off;
+    }
+  }
+  bool valid(const uint8_t* data, std::size_t size) const {
+    return first_high_ == SIZE_MAX ||
+           validateUtf8(data + first_high_, size - first_high_);
+  }
+
+  std::size_t first_high_ = SIZE_MAX;
+};
+
+// SIMD实现逐块检查，纯ASCII的块只需确认前一块末尾没有未完成的字符
+struct Sse42Utf8 {
+  __attribute__((target("sse4.2"))) void block(const uint8_t* p,
+                                               std::size_t,
+                                               uint64_t high) {
+    if (!high) {
+      error_ = _mm_or_si128(error_, incomplete_);
+      prev_ = _mm_setzero_si128();
+      incomplete_ = _mm_setzero_si128();
+      return;
+    }
+    for (int i = 0; i < 4; ++i) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+      check(v);
+      prev_ = v;
+    }
+    incomplete_ = _mm_subs_epu8(
+        prev_,
+        _mm_load_si128(reinterpret_cast<const __m128i*>(kIncomplete + 16)));
+  }
+
+  __attribute__((target("sse4.2"))) void check(__m128i v) {
+    auto prev1 = _mm_alignr_epi8(v, prev_, 15);
+    auto special = _mm_and_si128(
+        _mm_and_si128(lookup(kByte1High, _mm_srli_epi16(prev1, 4)),
+                      lookup(kByte1Low, prev1)),
+        lookup(kByte2High, _mm_srli_epi16(v, 4)));
+    auto third = _mm_subs_epu8(_mm_alignr_epi8(v, prev_, 14),
+                               _mm_set1_epi8(0xe0 - 0x80));
+    auto fourth = _mm_subs_epu8(_mm_alignr_epi8(v, prev_, 13),
+                                _mm_set1_epi8(0xf0 - 0x80));
+    auto must = _mm_and_si128(_mm_or_si128(third, fourth),
+                              _mm_set1_epi8(static_cast<char>(0x80)));
+    error_ = _mm_or_si128(error_, _mm_xor_si128(must, special));
+  }
+
+  __attribute__((target("sse4.2"))) bool valid(const uint8_t*,
+                                               std::size_t) const {
+    auto error = _mm_or_si128(error_, incomplete_);
+    return _mm_testz_si128(error, error);
+  }
+
+  __m128i prev_{};
+  __m128i error_{};
+  __m128i incomplete_{};
+};
+
+struct Avx2Utf8 {
+  __attribute__((target("avx2"))) void block(const uint8_t* p,
+                                             std::size_t,
+                                             uint64_t high) {
+    if (!high) {
+      error_ = _mm256_or_si256(error_, incomplete_);
+      prev_ = _mm256_setzero_si256();
+      incomplete_ = _mm256_setzero_si256();
+      return;
+    }
+    for (int i = 0; i < 2; ++i) {
+      auto v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+      check(v);
+      prev_ = v;
+    }
+    incomplete_ = _mm256_subs_epu8(
+        prev_,
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(kIncomplete)));
+  }
+
+  // alignr只在128位的半边内移位，先拼出跨半边的前一个128位
+  __attribute__((target("avx2"))) void check(__m256i v) {
+    auto shifted = _mm256_permute2x128_si256(prev_, v, 0x21);
+    auto prev1 = _mm256_alignr_epi8(v, shifted, 15);
+    auto special = _mm256_and_si256(
+        _mm256_and_si256(lookup(kByte1High, _mm256_srli_epi16(prev1, 4)),
+                         lookup(kByte1Low, prev1)),
+        lookup(kByte2High, _mm256_srli_epi16(v, 4)));
+    auto third = _mm256_subs_epu8(_mm256_alignr_epi8(v, shifted, 14),
+                                  _mm256_set1_epi8(0xe0 - 0x80));
+    auto fourth = _mm256_subs_epu8(_mm256_alignr_epi8(v, shifted, 13),
+                                   _mm256_set1_epi8(0xf0 - 0x80));
+    auto must = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                 _mm256_set1_epi8(static_cast<char>(0x80)));
+    error_ = _mm256_or_si256(error_, _mm256_xor_si256(must, special));
+  }
+
+  __attribute__((target("avx2"))) bool valid(const uint8_t*,
+                                             std::size_t) const {
+    auto error = _mm256_or_si256(error_, incomplete_);
+    return _mm256_testz_si256(error, error);
+  }
+
+  __m256i prev_{};
+  __m256i error_{};
+  __m256i incomplete_{};
+};
+
+// 被转义的字符：奇数个连续反斜杠之后的字符，escaped为跨块进位
+uint64_t findEscaped(uint64_t backslash, uint64_t& escaped) {
+  constexpr uint64_t kEven = 0x5555555555555555ull;
+  backslash &= ~escaped;
+  uint64_t follows = backslash << 1 | escaped;
+  uint64_t odd_starts = backslash & ~kEven & ~follows;
+  uint64_t even_starts;
+  escaped = __builtin_add_overflow(odd_starts, backslash, &even_starts);
+  uint64_t invert = even_starts << 1;
+  return (kEven ^ invert) & follows;
+}
+
+// 每一位为其自身及之前所有位的异或
+uint64_t prefixXor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+template <void (*Classify)(const uint8_t*, Masks&), typename Utf8>
+bool scan(std::string_view bytes, std::vector<uint32_t>& positions) {
+  auto data = reinterpret_cast<const uint8_t*>(bytes.data());
+  auto size = bytes.size();
+  positions.resize(size / 8 + 64);
+  auto count = std::size_t(0);
+
+  uint64_t escaped = 0;
+  uint64_t in_string = 0;
+  Utf8 utf8;
+  uint8_t tail[64];
+
+  for (std::size_t off = 0; off < size; off += 64) {
+    auto p = data + off;
+    if (size - off < 64) {
+      // 末尾不足64字节时以空格补齐
+      std::memset(tail, ' ', sizeof(tail));
+      std::memcpy(tail, p, size - off);
+      p = tail;
+    }
+
+    Masks m;
+    Classify(p, m);
+
+    auto quote = m.quote_ & ~findEscaped(m.backslash_, escaped);
+    // 字符串内部(含起始引号，不含结束引号)
+    auto inside = prefixXor(quote) ^ in_string;
+    in_string = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+
+    if (m.ctrl_ & inside) {
+      return false;
+    }
+    utf8.block(p, off, m.high_);
+
+    auto structural = (m.op_ & ~inside) | quote;
+    if (positions.size() - count < 64) {
+      positions.resize(positions.size() * 2);
+    }
+    auto out = positions.data() + count;
+    while (structural) {
+      *out++ = static_cast<uint32_t>(off + __builtin_ctzll(structural));
+      structural &= structural - 1;
+    }
+    count = out - positions.data();
+  }
+  positions.resize(count);
+
+  if (in_string) {
+    return false;
+  }
+  return utf8.valid(data, size);
+}
+
+// flatten使分类函数内联进扫描循环，循环体与分类函数使用同一指令集
+__attribute__((target("avx2"), flatten)) bool scanAvx2(
+    std::string_view bytes,
+    std::vector<uint32_t>& positions) {
+  return scan<avx2Masks, Avx2Utf8>(bytes, positions);
+}
+
+__attribute__((target("sse4.2"), flatten)) bool scanSse42(
+    std::string_view bytes,
+    std::vector<uint32_t>& positions) {
+  return scan<sse42Masks, Sse42Utf8>(bytes, positions);
+}
+
+}  // namespace
+
+Isa detectIsa() {
+  if (supported(Isa::Avx2)) {
+    return Isa::Avx2;
+  }
+  if (supported(Isa::Sse42)) {
+    return Isa::Sse42;
+  }
+  return Isa::Scalar;
+}
+
+bool supported(Isa isa) {
+  switch (isa) {
+    case Isa::Avx2:
+      return __builtin_cpu_supports("avx2");
+    case Isa::Sse42:
+      return __builtin_cpu_supports("sse4.2");
+    default:
+      return true;
+  }
+}
+
+bool buildIndex(std::string_view bytes,
+                std::vector<uint32_t>& positions,
+                Isa isa) {
+  if (bytes.size() > kMaxSize) {
+    return false;
+  }
+  switch (isa) {
+    case Isa::Avx2:
+      return scanAvx2(bytes, positions);
+    case Isa::Sse42:
+      return scanSse42(bytes, positions);
+    default:
+      return scan<scalarMasks, ScalarUtf8>(bytes, positions);
+  }
+}
+
+bool validateUtf8(const uint8_t* data, std::size_t size) {
+  std::size_t i = 0;
+  while (i < size) {
+    // 8字节全为ASCII时整体跳过
+    if (i + 8 <= size) {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      if ((word & 0x8080808080808080ull) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+
+    auto c = data[i];
+    if (c < 0x80) {
+      ++i;
+      continue;
+    }
+
+    std::size_t len;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xbf;
+    if (c >= 0xc2 && c <= 0xdf) {
+      len = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+      len = 3;
+      // 过长编码与代理区
+      lo = c == 0xe0 ? 0xa0 : 0x80;
+      hi = c == 0xed ? 0x9f : 0xbf;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+      len = 4;
+      lo = c == 0xf0 ? 0x90 : 0x80;
+      hi = c == 0xf4 ? 0x8f : 0xbf;
+    } else {
+      return false;
+    }
+
+    if (size - i < len || data[i + 1] < lo || data[i + 1] > hi) {
+      return false;
+    }
+    for (std::size_t k = 2; k < len; ++k) {
+      if ((data[i + k] & 0xc0) != 0x80) {
+        return false;
+      }
+    }
+    i += len;
+  }
+  return true;
+}
+
+}  // namespace parser::detail
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace parser::detail {
+
+/**
+ * @brief
+ * JSON解析的第一阶段：每次处理64字节，找出字符串之外的结构字符
+ * ({ } [ ] : ,)与所有未转义的引号，按出现顺序写入positions。
+ * 同时检查字符串内未转义的控制字符、未闭合的字符串与UTF-8编码，失败时返回false。
+ * SSE4.2与AVX2实现逐块以查表法检查UTF-8，纯ASCII的块只做一次判断。
+ * 数值与true/false/null不在索引中，由第二阶段在结构字符之间解析。
+ */
+enum class Isa {
+  Scalar,
+  Sse42,
+  Avx2,
+};
+
+// 当前CPU支持的最快实现
+Isa detectIsa();
+bool supported(Isa isa);
+
+// 文档不得超过kMaxSize，超过时返回false，调用方应先行检查
+constexpr std::size_t kMaxSize = UINT32_MAX;
+
+bool buildIndex(std::string_view bytes,
+                std::vector<uint32_t>& positions,
+                Isa isa);
+
+// 标量的UTF-8检查，拒绝过长编码、代理区与超出U+10FFFF的码点，
+// 标量实现的第一阶段与测试中用作参照
+bool validateUtf8(const uint8_t* data, std::size_t size);
+
+}  // namespace parser::detail
@@ -0,0 +1,316 @@
+#include "parser/json_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "parser/json.h"
+#include "utils/thread/wait.hpp"
+
+namespace parser {
+
+namespace {
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 切分数组时需要关注的字符
+enum : uint8_t {
+  kNone = 0,
+  kQuote,
+  kOpen,
+  kClose,
+  kComma,
+};
+
+struct Table {
+  constexpr Table() : cls_() {
+    cls_[static_cast<uint8_t>('"')] = kQuote;
+    cls_[static_cast<uint8_t>('[')] = kOpen;
+    cls_[static_cast<uint8_t>('{')] = kOpen;
+    cls_[static_cast<uint8_t>(']')] = kClose;
+    cls_[static_cast<uint8_t>('}')] = kClose;
+    cls_[static_cast<uint8_t>(',')] = kComma;
+  }
+  uint8_t cls_[256];
+};
+
+constexpr Table kTable;
+
+}  // namespace
+
+JsonStream::JsonStream() : JsonStream(Options()) {}
+
+JsonStream::JsonStream(const Options& options) : options_(options) {
+  if (options_.threads == 0) {
+    options_.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (options_.inflight == 0) {
+    options_.inflight = options_.threads * 2;
+  }
+  options_.chunk = std::max<std::size_t>(options_.chunk, 1);
+}
+
+JsonStream::~JsonStream() {
+  reset();
+}
+
+void JsonStream::open(std::string_view bytes) {
+  reset();
+  file_.close();
+  start(bytes);
+}
+
+bool JsonStream::openFile(const std::string& path) {
+  reset();
+  if (!file_.open(path)) {
+    return false;
+  }
+  start(file_.view());
+  return true;
+}
+
+void JsonStream::start(std::string_view bytes) {
+  bytes_ = bytes;
+  pool_ = std::make_unique<utils::thread::ThreadPool>(options_.threads);
+}
+
+void JsonStream::reset() {
+  {
+    std::scoped_lock lck(mtx_);
+    cancelled_ = true;
+  }
+  // 等待进行中的任务，队列中剩余的任务直接返回
+  pool_.reset();
+  inflight_.clear();
+  current_.reset();
+  offset_ = 0;
+  bytes_ = std::string_view();
+  pos_ = 0;
+  count_ = 0;
+  started_ = false;
+  finished_ = false;
+  std::scoped_lock lck(mtx_);
+  cancelled_ = false;
+}
+
+bool JsonStream::next(utils::Node& record, std::size_t* index) {
+  for (;;) {
+    if (current_) {
+      if (offset_ < current_->nodes_.size()) {
+        if (index) {
+          *index = current_->first_ + offset_;
+        }
+        record = std::move(current_->nodes_[offset_++]);
+        return true;
+      }
+      // 出错的记录之前已解析的记录照常取出
+      if (auto error = current_->error_; error) {
+        current_.reset();
+        std::rethrow_exception(error);
+      }
+      current_.reset();
+    }
+
+    while (inflight_.size() < options_.inflight) {
+      auto chunk = split();
+      if (!chunk) {
+        break;
+      }
+      submit(chunk);
+    }
+    if (inflight_.empty()) {
+      return false;
+    }
+
+    {
+      std::unique_lock lck(mtx_);
+      // 无序时出错的块在其他块都取出后才取出
+      auto clean = [](const std::shared_ptr<Chunk>& c) {
+        return c->done_ && !c->error_;
+      };
+      auto done = [](const std::shared_ptr<Chunk>& c) { return c->done_; };
+      auto ready = [this, &clean, &done]() {
+        if (options_.order == Order::Ordered) {
+          return inflight_.front()->done_;
+        }
+        return std::any_of(inflight_.begin(), inflight_.end(), clean) ||
+               std::all_of(inflight_.begin(), inflight_.end(), done);
+      };
+      utils::thread::wait(cv_, lck, ready);
+      auto iter = inflight_.begin();
+      if (options_.order == Order::Unordered) {
+        iter = std::find_if(inflight_.begin(), inflight_.end(), clean);
+        if (iter == inflight_.end()) {
+          iter = inflight_.begin();
+        }
+      }
+      current_ = *iter;
+      inflight_.erase(iter);
+    }
+    offset_ = 0;
+  }
+}
+
+bool JsonStream::forEach(std::string_view bytes, const Callback& callback) {
+  return forEach(bytes, callback, Options());
+}
+
+bool JsonStream::forEach(std::string_view bytes,
+                         const Callback& callback,
+                         const Options& options) {
+  JsonStream stream(options);
+  stream.open(bytes);
+  utils::Node record;
+  while (stream.next(record)) {
+    if (!callback(record)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<JsonStream::Chunk> JsonStream::split() {
+  if (finished_) {
+    return nullptr;
+  }
+  if (!started_) {
+    started_ = true;
+    format_ = options_.format;
+    auto first = std::find_if_not(bytes_.begin(), bytes_.end(), isSpace);
+    if (format_ == Format::Auto) {
+      format_ = first != bytes_.end() && *first == '[' ? Format::Array
+                                                       : Format::Lines;
+    }
+    if (format_ == Format::Array) {
+      if (first == bytes_.end() || *first != '[') {
+        throw std::invalid_argument("json stream: expected '['");
+      }
+      pos_ = first - bytes_.begin() + 1;
+    }
+  }
+
+  auto chunk = std::make_shared<Chunk>();
+  chunk->first_ = count_;
+  try {
+    if (format_ == Format::Lines) {
+      splitLines(*chunk);
+    } else {
+      splitArray(*chunk);
+    }
+  } catch (...) {
+    // 块中已切出的记录照常解析，错误排在这些记录与之前的块之后
+    chunk->error_ = std::current_exception();
+    finished_ = true;
+  }
+  count_ += chunk->records_.size();
+  return chunk->records_.empty() && !chunk->error_ ? nullptr : chunk;
+}
+
+void JsonStream::splitLines(Chunk& chunk) {
+  auto begin = pos_;
+  while (pos_ < bytes_.size() && pos_ - begin < options_.chunk) {
+    auto p = bytes_.data() + pos_;
+    auto nl = static_cast<const char*>(
+        std::memchr(p, '\n', bytes_.size() - pos_));
+    auto end = nl ? nl : bytes_.data() + bytes_.size();
+    // 跳过空行
+    if (std::find_if_not(p, end, isSpace) != end) {
+      chunk.records_.emplace_back(p, end - p);
+    }
+    pos_ = end - bytes_.data() + (nl ? 1 : 0);
+  }
+  finished_ = pos_ >= bytes_.size();
+}
+
+// 只跟踪字符串与嵌套深度，记录本身的合法性由解析时检查
+void JsonStream::splitArray(Chunk& chunk) {
+  auto data = reinterpret_cast<const uint8_t*>(bytes_.data());
+  auto size = bytes_.size();
+  auto begin = pos_;
+  auto record = pos_;
+  int depth = 0;
+
+  while (pos_ < size) {
+    switch (kTable.cls_[data[pos_]]) {
+      case kQuote: {
+        // 找到未转义的结束引号
+        auto p = pos_ + 1;
+        for (; p < size && data[p] != '"'; ++p) {
+          if (data[p] == '\\') {
+            ++p;
+          }
+        }
+        if (p >= size) {
+          throw std::invalid_argument("json stream: unterminated string");
+        }
+        pos_ = p;
+      } break;
+      case kOpen:
+        ++depth;
+        break;
+      case kClose:
+        if (depth-- == 0) {
+          // 数组结束
+          std::string_view last(bytes_.data() + record, pos_ - record);
+          if (std::find_if_not(last.begin(), last.end(), isSpace) !=
+              last.end()) {
+            chunk.records_.push_back(last);
+          } else if (!chunk.records_.empty() || count_ != 0) {
+            throw std::invalid_argument("json stream: trailing comma");
+          }
+          auto rest = bytes_.substr(pos_ + 1);
+          if (std::find_if_not(rest.begin(), rest.end(), isSpace) !=
+              rest.end()) {
+            throw std::invalid_argument("json stream: trailing content");
+          }
+          finished_ = true;
+          return;
+        }
+        break;
+      case kComma:
+        if (depth == 0) {
+          chunk.records_.emplace_back(bytes_.data() + record, pos_ - record);
+          record = pos_ + 1;
+          if (record - begin >= options_.chunk) {
+            pos_ = record;
+            return;
+          }
+        }
+        break;
+      default:
+        break;
+    }
+    ++pos_;
+  }
+  throw std::invalid_argument("json stream: unterminated array");
+}
+
+void JsonStream::submit(const std::shared_ptr<Chunk>& chunk) {
+  inflight_.push_back(chunk);
+  pool_->post([this, chunk]() {
+    {
+      std::scoped_lock lck(mtx_);
+      if (cancelled_) {
+        return;
+      }
+    }
+    try {
+      chunk->nodes_.reserve(chunk->records_.size());
+      for (auto record : chunk->records_) {
+        chunk->nodes_.push_back(Json::deserialize(record));
+      }
+    } catch (...) {
+      chunk->error_ = std::current_exception();
+    }
+    {
+      std::scoped_lock lck(mtx_);
+      chunk->done_ = true;
+    }
+    cv_.notify_all();
+  });
+}
+
+}  // namespace parser
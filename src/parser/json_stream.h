@@ -0,0 +1,126 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/mapped_file.h"
+#include "utils/meta.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/thread/annotations.hpp"
+#include "utils/thread/thread_pool.hpp"
+
+namespace parser {
+
+/**
+ * @brief
+ * 多线程读取NDJSON(每行一条记录)或顶层数组中的记录。
+ * 调用线程在记录边界处将输入切分为块，块在线程池中解析为互相独立的utils::Node，
+ * 按输入顺序或完成顺序通过next()/forEach取出。
+ * 已解析未取出的块不超过inflight个，内存占用与输入大小无关。
+ * Auto以首个非空白字符是否为'['区分两种格式，每行都是数组的NDJSON须指定Lines。
+ *
+ * e.g.
+ * parser::JsonStream stream;
+ * stream.openFile("events.ndjson");
+ * utils::Node record;
+ * while (stream.next(record)) {
+ *   ...
+ * }
+ */
+class JsonStream : public noncopyable {
+ public:
+  enum class Format {
+    Auto,
+    Lines,
+    Array,
+  };
+
+  enum class Order {
+    // 按输入顺序
+    Ordered,
+    // 按解析完成的顺序，next()给出记录在输入中的序号
+    Unordered,
+  };
+
+  struct Options {
+    Format format = Format::Auto;
+    Order order = Order::Ordered;
+    // 0为CPU核数
+    std::size_t threads = 0;
+    // 每块的目标字节数，块在此之后的第一个记录边界处结束
+    std::size_t chunk = 64 << 10;
+    // 已投递未取出的块数上限，0为线程数的两倍
+    std::size_t inflight = 0;
+  };
+
+  // 返回false时停止读取
+  using Callback = std::function<bool(utils::Node& record)>;
+
+  JsonStream();
+  explicit JsonStream(const Options& options);
+  ~JsonStream();
+
+  // 输入须在读取结束前保持有效
+  void open(std::string_view bytes);
+  bool openFile(const std::string& path);
+
+  /**
+   * @brief
+   * 取出下一条记录，读完时返回false。
+   * 输入格式错误或记录解析失败时抛出std::invalid_argument，
+   * 出错位置之前的记录先被取出；无序时出错的块在其他块都取出后才抛出
+   */
+  bool next(utils::Node& record, std::size_t* index = nullptr);
+
+  // 读取全部记录，回调返回false时提前结束并返回false
+  static bool forEach(std::string_view bytes, const Callback& callback);
+  static bool forEach(std::string_view bytes,
+                      const Callback& callback,
+                      const Options& options);
+
+ private:
+  struct Chunk {
+    std::size_t first_;
+    std::vector<std::string_view> records_;
+    std::vector<utils::Node> nodes_;
+    std::exception_ptr error_;
+    bool done_ = false;
+  };
+
+  void reset();
+  void start(std::string_view bytes);
+  // 切分出下一块，输入读完时返回nullptr
+  std::shared_ptr<Chunk> split();
+  void splitLines(Chunk& chunk);
+  void splitArray(Chunk& chunk);
+  void submit(const std::shared_ptr<Chunk>& chunk);
+
+  Options options_;
+  MappedFile file_;
+  std::string_view bytes_;
+  Format format_ = Format::Lines;
+  std::size_t pos_ = 0;
+  std::size_t count_ = 0;
+  bool started_ = false;
+  bool finished_ = false;
+
+  // 当前正在取出的块
+  std::shared_ptr<Chunk> current_;
+  std::size_t offset_ = 0;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<Chunk>> inflight_;
+  bool cancelled_ GAURDED_BY(mtx_) = false;
+  // 最先析构，等待已投递的任务结束
+  std::unique_ptr<utils::thread::ThreadPool> pool_;
+};
+
+}  // namespace parser
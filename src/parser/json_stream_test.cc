@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "parser/json_stream.h"
+#include "parser/parser.h"
+
+// 并行读取测试：./parser.json_stream_test [输入大小(MB)，默认64]
+// 对比单线程逐行解析/整体解析与JsonStream在不同线程数下的吞吐
+
+static std::string record(int64_t i) {
+  return R"({"ts":)" + std::to_string(1730000000000 + i * 37) +
+         R"(,"level":"INFO","msg":"request )" + std::to_string(i) +
+         R"( finished","fields":{"latency":)" +
+         std::to_string(i % 1000 * 0.125) + R"(,"status":200}})";
+}
+
+template <typename F>
+static void measure(const std::string& name, std::size_t bytes, F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  auto count = f();
+  auto cost = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                  .count();
+  std::cout << "  " << name << ": " << count << " records, "
+            << static_cast<double>(bytes) / (1 << 20) / cost << " MB/s"
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t size = (argc > 1 ? std::stoul(argv[1]) : 64) << 20;
+  std::string lines;
+  std::string array = "[";
+  for (int64_t i = 0; lines.size() < size; ++i) {
+    auto r = record(i);
+    lines += r + "\n";
+    array += (i == 0 ? "" : ",\n") + r;
+  }
+  array += "]";
+
+  std::cout << "ndjson:" << std::endl;
+  measure("sequential", lines.size(), [&lines]() {
+    std::size_t count = 0;
+    std::string_view rest(lines);
+    while (!rest.empty()) {
+      auto nl = rest.find('\n');
+      parser::Parser::deserialize("json", rest.substr(0, nl));
+      rest.remove_prefix(nl == std::string_view::npos ? rest.size() : nl + 1);
+      ++count;
+    }
+    return count;
+  });
+
+  std::size_t max_threads =
+      std::max(4u, std::thread::hardware_concurrency());
+  for (auto const* doc : {&lines, &array}) {
+    if (doc == &array) {
+      std::cout << "array:" << std::endl;
+      measure("sequential", array.size(), [&array]() {
+        return parser::Parser::deserialize("json", array).size();
+      });
+    }
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+      parser::JsonStream::Options options;
+      options.threads = threads;
+      measure("stream x" + std::to_string(threads), doc->size(),
+              [doc, &options]() {
+                std::size_t count = 0;
+                parser::JsonStream::forEach(
+                    *doc,
+                    [&count](utils::Node&) {
+                      ++count;
+                      return true;
+                    },
+                    options);
+                return count;
+              });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include "parser/json_stream.h"
+#include "parser/parser.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+
+static std::string lines(int count) {
+  std::string ret;
+  for (int i = 0; i < count; ++i) {
+    ret += R"({"id": )" + std::to_string(i) + R"(, "s": "a,]}\"[{\n"})";
+    ret += i % 3 == 0 ? "\r\n\n  \n" : "\n";
+  }
+  return ret;
+}
+
+static std::string array(int count) {
+  std::string ret = " [";
+  for (int i = 0; i < count; ++i) {
+    ret += i == 0 ? "\n" : ",\n";
+    ret += R"({"id": )" + std::to_string(i) +
+           R"(, "nested": [[1, {"x": "],\""}], []], "s": "\\"})";
+  }
+  return ret + "\n] ";
+}
+
+static parser::JsonStream::Options small(parser::JsonStream::Order order) {
+  parser::JsonStream::Options options;
+  options.order = order;
+  options.threads = 4;
+  options.chunk = 256;
+  options.inflight = 3;
+  return options;
+}
+
+TEST(JsonStream, Ordered) {
+  for (auto doc : {lines(1000), array(1000)}) {
+    parser::JsonStream stream(small(parser::JsonStream::Order::Ordered));
+    stream.open(doc);
+    utils::Node record;
+    std::size_t index;
+    int expected = 0;
+    while (stream.next(record, &index)) {
+      EXPECT_EQ(index, static_cast<std::size_t>(expected));
+      EXPECT_EQ(record["id"].as<int>(), expected++);
+    }
+    EXPECT_EQ(expected, 1000);
+  }
+}
+
+TEST(JsonStream, Unordered) {
+  auto doc = array(1000);
+  parser::JsonStream stream(small(parser::JsonStream::Order::Unordered));
+  stream.open(doc);
+  utils::Node record;
+  std::size_t index;
+  std::vector<int> ids;
+  while (stream.next(record, &index)) {
+    EXPECT_EQ(record["id"].as<std::size_t>(), index);
+    EXPECT_EQ(record["nested"][0][1]["x"].as<std::string>(), "],\"");
+    ids.push_back(record["id"].as<int>());
+  }
+  std::sort(ids.begin(), ids.end());
+  ASSERT_EQ(ids.size(), 1000u);
+  EXPECT_EQ(ids.front(), 0);
+  EXPECT_EQ(ids.back(), 999);
+}
+
+TEST(JsonStream, ForEach) {
+  int count = 0;
+  EXPECT_FALSE(parser::JsonStream::forEach(
+      lines(1000),
+      [&count](utils::Node& record) {
+        EXPECT_EQ(record["s"].as<std::string>(), "a,]}\"[{\n");
+        return ++count < 10;
+      },
+      small(parser::JsonStream::Order::Ordered)));
+  EXPECT_EQ(count, 10);
+
+  // 空数组与空输入
+  EXPECT_TRUE(parser::JsonStream::forEach(
+      "[ ]", [](utils::Node&) { return false; }));
+  EXPECT_TRUE(parser::JsonStream::forEach(
+      "\n\n", [](utils::Node&) { return false; }));
+
+  auto path = testing::TempDir() + "json_stream.ndjson";
+  {
+    std::ofstream ofs(path);
+    ofs << lines(100);
+  }
+  parser::JsonStream stream;
+  ASSERT_TRUE(stream.openFile(path));
+  utils::Node record;
+  count = 0;
+  while (stream.next(record)) {
+    ++count;
+  }
+  EXPECT_EQ(count, 100);
+  unlink(path.c_str());
+}
+
+TEST(JsonStream, Invalid) {
+  auto options = small(parser::JsonStream::Order::Ordered);
+  auto drain = [&options](const std::string& doc) {
+    parser::JsonStream::forEach(
+        doc, [](utils::Node&) { return true; }, options);
+  };
+  EXPECT_THROW(drain("[1, 2,]"), std::invalid_argument);
+  EXPECT_THROW(drain("[1, 2] 3"), std::invalid_argument);
+  EXPECT_THROW(drain("[1, \"2]"), std::invalid_argument);
+  EXPECT_THROW(drain("[1, {]"), std::invalid_argument);
+
+  // 记录解析失败时，之前的记录仍按顺序取出
+  auto doc = lines(500) + "{\"id\": }\n" + lines(10);
+  parser::JsonStream stream(options);
+  stream.open(doc);
+  utils::Node record;
+  int count = 0;
+  EXPECT_THROW(
+      {
+        while (stream.next(record)) {
+          ++count;
+        }
+      },
+      std::invalid_argument);
+  EXPECT_EQ(count, 500);
+
+  // 格式错误之前已切分出的记录都先取出
+  for (auto order : {parser::JsonStream::Order::Ordered,
+                     parser::JsonStream::Order::Unordered}) {
+    std::string truncated = array(10000);
+    truncated.resize(truncated.rfind(']'));
+    for (auto const& [bad, expected] :
+         {std::pair<std::string, std::size_t>{"[1,2,3", 2},
+          std::pair<std::string, std::size_t>{truncated, 9999}}) {
+      parser::JsonStream stream(small(order));
+      stream.open(bad);
+      std::size_t delivered = 0;
+      EXPECT_THROW(
+          {
+            while (stream.next(record)) {
+              ++delivered;
+            }
+          },
+          std::invalid_argument);
+      EXPECT_EQ(delivered, expected);
+    }
+  }
+
+  options.format = parser::JsonStream::Format::Array;
+  EXPECT_THROW(drain("{\"a\": 1}"), std::invalid_argument);
+}
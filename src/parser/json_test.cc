@@ -0,0 +1,116 @@
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parser/json.h"
+#include "parser/json_index.h"
+#include "parser/parser.h"
+#include "utils/meta.hpp"
+
+// JSON反序列化吞吐测试：./parser.json_test [最大文档大小(MB)，默认64]
+// 对比nlohmann DOM再转换为utils::Node的旧路径与两阶段解析，
+// 并单独统计各指令集下第一阶段(结构字符索引)的吞吐
+
+static utils::Node convert(const nlohmann::json& j) {
+  utils::Node n;
+  if (j.is_object()) {
+    for (auto it = j.begin(); it != j.end(); ++it) {
+      n[it.key()] = convert(it.value());
+    }
+  } else if (j.is_array()) {
+    for (auto it = j.begin(); it != j.end(); ++it) {
+      n.push_back(convert(*it));
+    }
+  } else if (j.is_boolean()) {
+    n = j.get<bool>();
+  } else if (j.is_number_integer()) {
+    n = j.get<int64_t>();
+  } else if (j.is_number_float()) {
+    n = j.get<double>();
+  } else if (j.is_string()) {
+    n = j.get<std::string>();
+  }
+  return n;
+}
+
+// 生成约size字节的日志记录数组
+static std::string generate(std::size_t size) {
+  static const char* levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+  std::string ret = "[";
+  for (int64_t i = 0; ret.size() < size; ++i) {
+    if (i != 0) {
+      ret += ",\n";
+    }
+    ret += R"({"ts":)" + std::to_string(1730000000000 + i * 37) +
+           R"(,"level":")" + levels[i % 4] + R"(","thread":)" +
+           std::to_string(i % 16) + R"(,"module":"core.thread","msg":"request )" +
+           std::to_string(i) +
+           R"( finished in 12.5 ms, path=\"/api/v1/items\"","fields":{"latency":)" +
+           std::to_string(i % 1000 * 0.125) + R"(,"status":200,"ok":true}})";
+  }
+  ret += "]";
+  return ret;
+}
+
+// 重复到至少200ms，返回平均吞吐
+template <typename F>
+static double measure(const std::string& bytes, F&& f) {
+  int rounds = 0;
+  double cost = 0;
+  auto start = std::chrono::steady_clock::now();
+  do {
+    auto n = f(bytes);
+    if (!n.isArray()) {
+      std::cerr << "parse failed" << std::endl;
+    }
+    ++rounds;
+    cost = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+               .count();
+  } while (cost < 0.2);
+  return static_cast<double>(bytes.size()) * rounds / (1 << 20) / cost;
+}
+
+int main(int argc, char** argv) {
+  using parser::Json;
+  using parser::detail::Isa;
+  static const std::pair<const char*, Json::Backend> backends[] = {
+      {"avx2", Json::Backend::Avx2},
+      {"sse4.2", Json::Backend::Sse42},
+      {"scalar", Json::Backend::Scalar},
+  };
+
+  std::size_t max_mb = argc > 1 ? std::stoul(argv[1]) : 64;
+  for (std::size_t mb = 1; mb <= max_mb; mb *= 4) {
+    auto bytes = generate(mb << 20);
+    std::cout << mb << " MB:" << std::endl;
+    auto dom = measure(bytes, [](const std::string& b) {
+      return convert(nlohmann::json::parse(b));
+    });
+    std::cout << "  nlohmann dom: " << dom << " MB/s" << std::endl;
+
+    for (auto [name, backend] : backends) {
+      Json::setBackend(backend);
+      std::vector<uint32_t> positions;
+      auto index = measure(bytes, [&positions, backend = backend](
+                                      const std::string& b) {
+        auto isa = backend == Json::Backend::Avx2    ? Isa::Avx2
+                   : backend == Json::Backend::Sse42 ? Isa::Sse42
+                                                     : Isa::Scalar;
+        parser::detail::buildIndex(b, positions, isa);
+        return utils::Node::makeArray();
+      });
+      auto full = measure(bytes, [](const std::string& b) {
+        return parser::Parser::deserialize("json", b);
+      });
+      std::cout << "  " << name << ": index " << index << " MB/s, parse "
+                << full << " MB/s" << std::endl;
+    }
+    Json::setBackend(Json::Backend::Auto);
+  }
+  return 0;
+}
@@ -1,7 +1,12 @@
 #include "utils/meta.hpp"
+#include "parser/json.h"
+#include "parser/json_index.h"
 #include "parser/parser.h"
 
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <random>
 
 const char json[] =
     "{\"result\":{\"swing_a\": 1.0, \"swing_b\": 0.0},\"error\": [0.0, 0.1]}";
@@ -12,4 +17,183 @@ TEST(Json, Parser) {
   EXPECT_EQ(n.isMap(), true);
   EXPECT_EQ(n["result"]["swing_a"].as<double>(), 1.0);
   EXPECT_EQ(n["error"][1].as<double>(), 0.1);
-}
\ No newline at end of file
+}
+TEST(Json, Integer) {
+  auto n = parser::Parser::deserialize(
+      "json",
+      R"({"big": 9007199254740993, "min": -9223372036854775808,)"
+      R"( "umax": 18446744073709551615, "small": 7})");
+  EXPECT_EQ(n["big"].as<int64_t>(), 9007199254740993);
+  EXPECT_EQ(n["min"].as<int64_t>(), INT64_MIN);
+  EXPECT_TRUE(n["umax"].isUnsigned());
+  EXPECT_EQ(n["umax"].as<uint64_t>(), UINT64_MAX);
+  EXPECT_FALSE(n["small"].isUnsigned());
+  EXPECT_EQ(n["small"].as<int>(), 7);
+
+  // 序列化后数值不变
+  auto bytes = parser::Parser::serialize("json", n);
+  auto m = parser::Parser::deserialize("json", bytes);
+  EXPECT_EQ(m["big"].as<int64_t>(), 9007199254740993);
+  EXPECT_EQ(m["umax"].as<uint64_t>(), UINT64_MAX);
+}
+
+TEST(Json, Nested) {
+  auto n = parser::Parser::deserialize(
+      "json",
+      R"({"a": {"b": [1, [2, 3], {"c": "d"}], "e": {}}, "f": [], "g": null,)"
+      R"( "h": true})");
+  EXPECT_EQ(n["a"]["b"][0].as<int>(), 1);
+  EXPECT_EQ(n["a"]["b"][1][1].as<int>(), 3);
+  EXPECT_EQ(n["a"]["b"][2]["c"].as<std::string>(), "d");
+  EXPECT_TRUE(n["a"]["e"].isMap());
+  EXPECT_EQ(n["a"]["e"].size(), 0u);
+  EXPECT_TRUE(n["f"].isArray());
+  EXPECT_EQ(n["f"].size(), 0u);
+  EXPECT_FALSE(n["g"].isValid());
+  EXPECT_TRUE(n["h"].as<bool>());
+
+  EXPECT_ANY_THROW(parser::Parser::deserialize("json", R"({"a": [1, 2})"));
+}
+
+static const parser::Json::Backend kBackends[] = {
+    parser::Json::Backend::Avx2,
+    parser::Json::Backend::Sse42,
+    parser::Json::Backend::Scalar,
+};
+
+// 与nlohmann的解析结果比较
+static void expectSame(const std::string& doc) {
+  auto expected = nlohmann::json::parse(doc);
+  for (auto backend : kBackends) {
+    parser::Json::setBackend(backend);
+    auto n = parser::Parser::deserialize("json", doc);
+    EXPECT_EQ(nlohmann::json::parse(parser::Parser::serialize("json", n)),
+              expected)
+        << doc;
+  }
+  parser::Json::setBackend(parser::Json::Backend::Auto);
+}
+
+static void expectInvalid(const std::string& doc) {
+  EXPECT_ANY_THROW(nlohmann::json::parse(doc)) << doc;
+  for (auto backend : kBackends) {
+    parser::Json::setBackend(backend);
+    EXPECT_ANY_THROW(parser::Parser::deserialize("json", doc)) << doc;
+  }
+  parser::Json::setBackend(parser::Json::Backend::Auto);
+}
+
+TEST(Json, Escape) {
+  expectSame(R"(["a\"b", "\\\\", "\\\"", "\/\b\f\n\r\t"])");
+  expectSame(R"({"\u00e9\u4e2d": "\ud83d\ude00", "é中😀": 1})");
+
+  // 反斜杠序列与引号跨越64字节的块边界
+  for (int pad = 50; pad < 70; ++pad) {
+    for (int slashes = 1; slashes <= 5; ++slashes) {
+      std::string doc = "[\"" + std::string(pad, 'x');
+      for (int i = 0; i < slashes * 2; ++i) {
+        doc += '\\';
+      }
+      doc += "\", \"" + std::string(pad, 'y') + "\\\"\"]";
+      expectSame(doc);
+    }
+  }
+}
+
+TEST(Json, Invalid) {
+  for (const char* doc :
+       {"", "  ", "{", "[1,]", R"({"a"})", R"({"a":1,})", "01", "1.", "-",
+        "tru", "nul", "[1 2]", R"({"a" 1})", "{}}", "[]]", "1e999", R"("abc)",
+        "\"a\x01b\"", "\"\xff\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"",
+        R"(["\ud800"])", R"(["\x"])", R"({1: 2})", "[1]x"}) {
+    expectInvalid(doc);
+  }
+}
+
+// 各指令集的UTF-8检查与标量实现一致，多字节字符与错误落在块边界两侧
+TEST(Json, Utf8) {
+  using parser::detail::Isa;
+  static const char* pieces[] = {
+      "a", "é", "中", "😀", "\xef\xbf\xbf", "\xf4\x8f\xbf\xbf",
+      // 以下各自非法
+      "\x80", "\xc1\xbf", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xf0\x8f\xbf\xbf",
+      "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\xe4\xb8", "\xc3"};
+  std::mt19937 rng(20241107);
+  for (int i = 0; i < 2000; ++i) {
+    std::string body(rng() % 130, 'x');
+    auto bad = i % 2 == 0;
+    for (auto n = rng() % 4 + 1; n > 0; --n) {
+      auto piece = pieces[rng() % (bad ? 16 : 6)];
+      body.insert(rng() % (body.size() + 1), piece);
+    }
+    auto doc = "\"" + body + "\"";
+    auto expected = parser::detail::validateUtf8(
+        reinterpret_cast<const uint8_t*>(body.data()), body.size());
+    for (auto isa : {Isa::Avx2, Isa::Sse42, Isa::Scalar}) {
+      if (!parser::detail::supported(isa)) {
+        continue;
+      }
+      std::vector<uint32_t> positions;
+      EXPECT_EQ(parser::detail::buildIndex(doc, positions, isa), expected)
+          << static_cast<int>(isa) << " " << doc;
+    }
+  }
+}
+
+// 随机生成的文档
+static void generate(std::mt19937& rng, int depth, std::string& out) {
+  auto pick = rng() % (depth > 4 ? 6 : 8);
+  switch (pick) {
+    case 0:
+      out += std::to_string(static_cast<int64_t>(rng()) - (1ll << 31));
+      break;
+    case 1:
+      out += std::to_string(static_cast<uint64_t>(rng()) << 32 | rng());
+      break;
+    case 2:
+      out += std::to_string((static_cast<double>(rng()) - 2e9) / 1e3) + "e" +
+             std::to_string(static_cast<int>(rng() % 40) - 20);
+      break;
+    case 3:
+      out += rng() % 2 ? "true" : "false";
+      break;
+    case 4:
+      out += "null";
+      break;
+    case 5: {
+      static const char* pieces[] = {"a", "\\\\", "\\\"", "\\n", "\\u00e9",
+                                     "中", " ", "{[,:]}"};
+      out += '"';
+      for (auto n = rng() % 12; n > 0; --n) {
+        out += pieces[rng() % 8];
+      }
+      out += '"';
+    } break;
+    case 6: {
+      out += "[ ";
+      for (auto n = rng() % 6; n > 0; --n) {
+        generate(rng, depth + 1, out);
+        out += n > 1 ? " ,\n" : "";
+      }
+      out += "]";
+    } break;
+    default: {
+      out += "{";
+      for (auto n = rng() % 6; n > 0; --n) {
+        out += "\"k" + std::to_string(rng() % 100) + "\" :\t";
+        generate(rng, depth + 1, out);
+        out += n > 1 ? "," : "";
+      }
+      out += "}";
+    } break;
+  }
+}
+
+TEST(Json, Random) {
+  std::mt19937 rng(20241031);
+  for (int i = 0; i < 300; ++i) {
+    std::string doc;
+    generate(rng, 0, doc);
+    expectSame(doc);
+  }
+}
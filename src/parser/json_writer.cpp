@@ -0,0 +1,235 @@
+#include "parser/json_writer.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace parser {
+
+namespace {
+
+// 需要转义的字符
+struct EscapeTable {
+  constexpr EscapeTable() : escape_() {
+    for (int c = 0; c < 0x20; ++c) {
+      escape_[c] = true;
+    }
+    escape_[static_cast<uint8_t>('"')] = true;
+    escape_[static_cast<uint8_t>('\\')] = true;
+  }
+  bool escape_[256];
+};
+
+constexpr EscapeTable kEscape;
+
+// 长字符串按段转义，每段转义后不超过3KB，在输出缓冲区预留的余量之内
+constexpr std::size_t kSegment = 512;
+
+class Writer {
+ public:
+  Writer(std::string& buf,
+         int indent,
+         std::size_t chunk,
+         const JsonWriter::Sink* sink)
+      : buf_(buf), indent_(indent), chunk_(chunk), sink_(sink) {}
+
+  bool write(const utils::Node& node) {
+    value(node, 0);
+    return flush(true);
+  }
+
+ private:
+  void value(const utils::Node& node, int depth) {
+    if (node.isMap()) {
+      if (node.size() == 0) {
+        buf_ += "{}";
+        return;
+      }
+      buf_ += '{';
+      bool first = true;
+      for (auto iter = node.begin(), end = node.end(); iter != end; ++iter) {
+        if (!first) {
+          buf_ += ',';
+        }
+        first = false;
+        newline(depth + 1);
+        string(iter->first);
+        buf_ += indent_ < 0 ? ":" : ": ";
+        value(iter->second, depth + 1);
+        if (!flush(false)) {
+          return;
+        }
+      }
+      newline(depth);
+      buf_ += '}';
+    } else if (node.isArray()) {
+      if (node.size() == 0) {
+        buf_ += "[]";
+        return;
+      }
+      buf_ += '[';
+      bool first = true;
+      for (auto iter = node.begin(), end = node.end(); iter != end; ++iter) {
+        if (!first) {
+          buf_ += ',';
+        }
+        first = false;
+        newline(depth + 1);
+        value(*iter, depth + 1);
+        if (!flush(false)) {
+          return;
+        }
+      }
+      newline(depth);
+      buf_ += ']';
+    } else if (node.isBool()) {
+      buf_ += node.as<bool>() ? "true" : "false";
+    } else if (node.isUnsigned()) {
+      number(node.as<uint64_t>());
+    } else if (node.isInteger()) {
+      number(node.as<int64_t>());
+    } else if (node.isDouble()) {
+      real(node.as<double>());
+    } else if (node.isString()) {
+      string(node.view());
+    } else {
+      buf_ += "null";
+    }
+  }
+
+  void newline(int depth) {
+    if (indent_ >= 0) {
+      buf_ += '\n';
+      buf_.append(static_cast<std::size_t>(depth) * indent_, ' ');
+    }
+  }
+
+  template <typename T>
+  void number(T val) {
+    char tmp[24];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), val);
+    buf_.append(tmp, res.ptr);
+  }
+
+  // 最短的可还原表示，整数值补".0"以便解析后仍为浮点
+  void real(double val) {
+    if (!std::isfinite(val)) {
+      buf_ += "null";
+      return;
+    }
+    char tmp[32];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), val);
+    buf_.append(tmp, res.ptr);
+    if (std::string_view(tmp, res.ptr - tmp).find_first_of(".e") ==
+        std::string_view::npos) {
+      buf_ += ".0";
+    }
+  }
+
+  // 每段之后检查是否需要输出，单个字符串不会使缓冲区超过块大小太多
+  void string(std::string_view str) {
+    buf_ += '"';
+    while (!str.empty()) {
+      auto n = std::min(str.size(), kSegment);
+      escape(str.substr(0, n));
+      str.remove_prefix(n);
+      if (!flush(false)) {
+        return;
+      }
+    }
+    buf_ += '"';
+  }
+
+  void escape(std::string_view str) {
+    static const char hex[] = "0123456789abcdef";
+    auto begin = str.data();
+    auto end = begin + str.size();
+    for (auto p = begin; p < end; ++p) {
+      auto c = static_cast<uint8_t>(*p);
+      if (!kEscape.escape_[c]) {
+        continue;
+      }
+      buf_.append(begin, p);
+      begin = p + 1;
+      switch (c) {
+        case '"':
+          buf_ += "\\\"";
+          break;
+        case '\\':
+          buf_ += "\\\\";
+          break;
+        case '\b':
+          buf_ += "\\b";
+          break;
+        case '\f':
+          buf_ += "\\f";
+          break;
+        case '\n':
+          buf_ += "\\n";
+          break;
+        case '\r':
+          buf_ += "\\r";
+          break;
+        case '\t':
+          buf_ += "\\t";
+          break;
+        default: {
+          char esc[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+          buf_.append(esc, sizeof(esc));
+        } break;
+      }
+    }
+    buf_.append(begin, end);
+  }
+
+  // 缓冲区超过块大小时交给sink，final时输出全部剩余内容
+  bool flush(bool final) {
+    if (!sink_ || failed_) {
+      return !failed_;
+    }
+    if (buf_.size() >= chunk_ || (final && !buf_.empty())) {
+      failed_ = !(*sink_)(buf_);
+      buf_.clear();
+    }
+    return !failed_;
+  }
+
+  std::string& buf_;
+  int indent_;
+  std::size_t chunk_;
+  const JsonWriter::Sink* sink_;
+  bool failed_ = false;
+};
+
+}  // namespace
+
+void JsonWriter::write(const utils::Node& node, std::string& out) const {
+  Writer(out, indent_, chunk_, nullptr).write(node);
+}
+
+bool JsonWriter::write(const utils::Node& node, int fd) const {
+  return write(node, [fd](std::string_view chunk) {
+    while (!chunk.empty()) {
+      auto ret = ::write(fd, chunk.data(), chunk.size());
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      chunk.remove_prefix(static_cast<std::size_t>(ret));
+    }
+    return true;
+  });
+}
+
+bool JsonWriter::write(const utils::Node& node, const Sink& sink) const {
+  std::string buf;
+  buf.reserve(chunk_ + 4096);
+  return Writer(buf, indent_, chunk_, &sink).write(node);
+}
+
+}  // namespace parser
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "utils/meta.hpp"
+
+namespace parser {
+
+/**
+ * @brief
+ * 遍历一次utils::Node直接输出JSON，不构造中间的文档树。
+ * 写入字符串时追加到调用方的缓冲区，可在多次调用间复用；
+ * 写入fd或Sink时按块输出，长字符串分段转义并输出，
+ * 缓冲区只比块大小多出一段转义后的字符串。
+ * indent小于0时输出紧凑格式，否则每层缩进indent个空格。
+ * NaN与无穷没有JSON表示，输出为null。
+ *
+ * e.g.
+ * parser::JsonWriter writer(2);
+ * writer.write(node, STDOUT_FILENO);
+ * writer.write(node, [&conn](std::string_view chunk) {
+ *   return conn.send(chunk.data(), chunk.size()) == chunk.size();
+ * });
+ */
+class JsonWriter {
+ public:
+  // 返回false时停止输出
+  using Sink = std::function<bool(std::string_view)>;
+
+  explicit JsonWriter(int indent = -1, std::size_t chunk = 64 << 10)
+      : indent_(indent), chunk_(chunk) {}
+
+  void write(const utils::Node& node, std::string& out) const;
+  bool write(const utils::Node& node, int fd) const;
+  bool write(const utils::Node& node, const Sink& sink) const;
+
+ private:
+  int indent_;
+  std::size_t chunk_;
+};
+
+}  // namespace parser
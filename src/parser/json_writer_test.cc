@@ -0,0 +1,131 @@
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "parser/json_writer.h"
+#include "utils/meta.hpp"
+
+// JSON序列化测试：./parser.json_writer_test [输出大小(MB)，默认64]
+// 对比转换为nlohmann再经stringstream输出的旧路径、写入字符串与分块写入fd，
+// 统计耗时，以及在子进程中重复执行时相对fork时的峰值内存增量
+
+static nlohmann::json convert(const utils::Node& node) {
+  nlohmann::json j;
+  if (node.isMap()) {
+    j = nlohmann::json::object();
+    for (auto iter = node.begin(); iter != node.end(); ++iter) {
+      j[iter->first] = convert(iter->second);
+    }
+  } else if (node.isArray()) {
+    j = nlohmann::json::array();
+    for (auto iter = node.begin(); iter != node.end(); ++iter) {
+      j.push_back(convert(*iter));
+    }
+  } else if (node.isBool()) {
+    j = node.as<bool>();
+  } else if (node.isInteger()) {
+    j = node.as<int64_t>();
+  } else if (node.isDouble()) {
+    j = node.as<double>();
+  } else if (node.isString()) {
+    j = node.as<std::string>();
+  }
+  return j;
+}
+
+static utils::Node generate(std::size_t size) {
+  utils::Node n = utils::Node::makeArray();
+  // 每条记录约150字节
+  for (std::size_t i = 0; i < size / 150; ++i) {
+    utils::Node r;
+    r["ts"] = static_cast<int64_t>(1730000000000 + i * 37);
+    r["level"] = "INFO";
+    r["msg"] = "request " + std::to_string(i) + " finished, path=\"/api\"";
+    r["fields"]["latency"] = i % 1000 * 0.125;
+    r["fields"]["status"] = 200;
+    n.push_back(r);
+  }
+  return n;
+}
+
+static long rssKb() {
+  std::ifstream ifs("/proc/self/statm");
+  long size, resident;
+  ifs >> size >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// 耗时在当前进程中统计；峰值内存在子进程中统计，
+// 避免写时复制(引用计数的修改)的缺页计入耗时
+static void measure(const std::string& name,
+                    const std::function<std::size_t()>& f) {
+  // 归还之前的测量释放的内存，使其不计入fork时的基准
+  malloc_trim(0);
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return;
+  }
+  auto pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    auto base = rssKb();
+    f();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long peak = (usage.ru_maxrss - base) >> 10;
+    (void)!write(fds[1], &peak, sizeof(peak));
+    _exit(0);
+  }
+  close(fds[1]);
+  long peak = -1;
+  (void)!read(fds[0], &peak, sizeof(peak));
+  close(fds[0]);
+  waitpid(pid, nullptr, 0);
+
+  auto start = std::chrono::steady_clock::now();
+  auto bytes = f();
+  auto cost = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  std::cout << name << ": " << (bytes >> 20) << " MB in " << cost
+            << " ms, peak +" << peak << " MB" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t mb = argc > 1 ? std::stoul(argv[1]) : 64;
+  auto node = generate(mb << 20);
+
+  measure("nlohmann+stringstream", [&node]() {
+    std::stringstream sstm;
+    sstm << convert(node);
+    return sstm.str().size();
+  });
+  measure("writer string", [&node]() {
+    std::string out;
+    parser::JsonWriter().write(node, out);
+    return out.size();
+  });
+  measure("writer fd", [&node]() {
+    std::size_t bytes = 0;
+    auto fd = open("/dev/null", O_WRONLY);
+    parser::JsonWriter().write(node, [fd, &bytes](std::string_view chunk) {
+      bytes += chunk.size();
+      return write(fd, chunk.data(), chunk.size()) ==
+             static_cast<ssize_t>(chunk.size());
+    });
+    close(fd);
+    return bytes;
+  });
+  return 0;
+}
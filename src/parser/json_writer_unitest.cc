@@ -0,0 +1,117 @@
+#include "parser/json_writer.h"
+#include "parser/parser.h"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cmath>
+
+static utils::Node sample() {
+  utils::Node n;
+  n["int"] = -42;
+  n["uint"] = UINT64_MAX;
+  n["bool"] = false;
+  n["null"] = utils::Node();
+  n["escape"] = std::string("q\"b\\n\n\t\x01\x1f/é");
+  n["empty_map"] = utils::Node::makeMap();
+  n["empty_array"] = utils::Node::makeArray();
+  n["nested"]["list"].push_back(1);
+  n["nested"]["list"].push_back("two");
+  n["nested"]["list"].push_back(utils::Node::makeArray());
+  return n;
+}
+
+TEST(JsonWriter, Format) {
+  auto n = sample();
+  auto expected = nlohmann::json::parse(parser::Parser::serialize("json", n));
+
+  // 不含浮点时与nlohmann的输出逐字节一致
+  std::string compact;
+  parser::JsonWriter().write(n, compact);
+  EXPECT_EQ(compact, expected.dump());
+
+  std::string pretty;
+  parser::JsonWriter(4).write(n, pretty);
+  EXPECT_EQ(pretty, expected.dump(4));
+
+  // 追加到已有内容之后
+  std::string buf = "prefix";
+  parser::JsonWriter().write(utils::Node(1), buf);
+  EXPECT_EQ(buf, "prefix1");
+}
+
+TEST(JsonWriter, Double) {
+  for (double val : {0.1, 1.0, -2.5e-300, 1e20, 123456789.125, -0.0}) {
+    std::string out;
+    parser::JsonWriter().write(utils::Node(val), out);
+    auto n = parser::Parser::deserialize("json", out);
+    EXPECT_TRUE(n.isDouble()) << out;
+    EXPECT_EQ(n.as<double>(), val) << out;
+  }
+
+  std::string out;
+  parser::JsonWriter().write(utils::Node(std::nan("")), out);
+  EXPECT_EQ(out, "null");
+}
+
+TEST(JsonWriter, Chunk) {
+  utils::Node n;
+  for (int i = 0; i < 10000; ++i) {
+    n["items"].push_back("item_" + std::to_string(i));
+  }
+  std::string expected;
+  parser::JsonWriter(2).write(n, expected);
+
+  std::string joined;
+  std::size_t chunks = 0;
+  EXPECT_TRUE(parser::JsonWriter(2, 1024).write(
+      n, [&joined, &chunks](std::string_view chunk) {
+        EXPECT_LT(chunk.size(), 2048u);
+        joined.append(chunk);
+        ++chunks;
+        return true;
+      }));
+  EXPECT_EQ(joined, expected);
+  EXPECT_GT(chunks, 10u);
+
+  // sink失败时停止输出
+  std::size_t calls = 0;
+  EXPECT_FALSE(parser::JsonWriter(2, 1024).write(
+      n, [&calls](std::string_view) { return ++calls < 3; }));
+  EXPECT_EQ(calls, 3u);
+
+  // 长字符串分段输出，每块不超过块大小加一段转义后的字符串
+  utils::Node big;
+  big["text"] = std::string(100000, 'x') + std::string(1000, '\n');
+  expected.clear();
+  parser::JsonWriter().write(big, expected);
+  joined.clear();
+  chunks = 0;
+  EXPECT_TRUE(parser::JsonWriter(-1, 1024).write(
+      big, [&joined, &chunks](std::string_view chunk) {
+        EXPECT_LE(chunk.size(), 1024u + 4096u);
+        joined.append(chunk);
+        ++chunks;
+        return true;
+      }));
+  EXPECT_EQ(joined, expected);
+  EXPECT_GT(chunks, 90u);
+}
+
+TEST(JsonWriter, Fd) {
+  auto path = testing::TempDir() + "json_writer.json";
+  auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  ASSERT_NE(fd, -1);
+  EXPECT_TRUE(parser::JsonWriter(-1, 64).write(sample(), fd));
+  ::close(fd);
+
+  auto n = parser::Parser::read(path);
+  EXPECT_EQ(n["uint"].as<uint64_t>(), UINT64_MAX);
+  EXPECT_EQ(n["escape"].as<std::string>(), sample()["escape"].as<std::string>());
+  EXPECT_EQ(n["nested"]["list"][1].as<std::string>(), "two");
+  unlink(path.c_str());
+
+  EXPECT_FALSE(parser::JsonWriter().write(sample(), -1));
+}
@@ -0,0 +1,91 @@
+#include "parser/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace parser {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    addr_ = std::exchange(other.addr_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+    open_ = std::exchange(other.open_, false);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const std::string& path, Access access) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    auto size = static_cast<std::size_t>(st.st_size);
+    bool sequential = access == Access::Sequential;
+    auto addr = ::mmap(nullptr, size, PROT_READ,
+                       MAP_PRIVATE | (sequential ? MAP_POPULATE : 0), fd, 0);
+    if (addr != MAP_FAILED) {
+      if (sequential) {
+        // MAP_POPULATE已预读全部页面，顺序访问提示让内核及早回收已读过的页
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+      }
+      ::close(fd);
+      addr_ = addr;
+      size_ = size;
+      open_ = true;
+      return true;
+    }
+  }
+
+  // 大小未知或无法映射，读到文件末尾
+  char buf[65536];
+  ssize_t ret;
+  while ((ret = ::read(fd, buf, sizeof(buf))) > 0) {
+    buffer_.append(buf, static_cast<std::size_t>(ret));
+  }
+  ::close(fd);
+  if (ret < 0) {
+    buffer_.clear();
+    return false;
+  }
+  size_ = buffer_.size();
+  open_ = true;
+  return true;
+}
+
+void MappedFile::close() {
+  if (addr_) {
+    ::munmap(addr_, size_);
+    addr_ = nullptr;
+  }
+  size_ = 0;
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  open_ = false;
+}
+
+std::string_view MappedFile::view() const {
+  if (addr_) {
+    return std::string_view(static_cast<const char*>(addr_), size_);
+  }
+  return buffer_;
+}
+
+}  // namespace parser
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "utils/noncopyable.hpp"
+
+namespace parser {
+
+/**
+ * @brief
+ * 以只读方式将整个文件映射到内存，内容通过view()零拷贝访问。
+ * Sequential在映射时预读全部页面并提示内核顺序访问，适合一次解析整个文件；
+ * OnDemand只建立映射，页面在首次访问时才读入，打开的耗时与文件大小无关。
+ * 无法映射的文件(如管道、procfs)退化为一次性读入内存。
+ * 映射期间文件被其他写者截断时，访问超出新长度的页面会触发SIGBUS。
+ */
+class MappedFile : public noncopyable {
+ public:
+  enum class Access {
+    Sequential,
+    OnDemand,
+  };
+
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path,
+                      Access access = Access::Sequential) {
+    open(path, access);
+  }
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  bool open(const std::string& path, Access access = Access::Sequential);
+  void close();
+
+  bool isOpen() const { return open_; }
+  // 内容是否来自映射，否则来自读入的缓冲区
+  bool isMapped() const { return addr_ != nullptr; }
+  std::string_view view() const;
+  std::size_t size() const { return size_; }
+
+ private:
+  void* addr_ = nullptr;
+  std::size_t size_ = 0;
+  std::string buffer_;
+  bool open_ = false;
+};
+
+}  // namespace parser
@@ -0,0 +1,78 @@
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "parser/mapped_file.h"
+#include "parser/parser.h"
+
+// Parser::read读取路径测试：./parser.mapped_file_test [文件大小(MB)，默认64]
+// 对比fstream读入stringstream再str()复制的旧路径与只读映射的新路径，
+// 分别统计取得输入的耗时、此时的堆占用，以及包含解析的总耗时
+
+static std::string generate(std::size_t size) {
+  std::string ret = "[";
+  for (int64_t i = 0; ret.size() < size; ++i) {
+    if (i != 0) {
+      ret += ",";
+    }
+    ret += R"({"id":)" + std::to_string(i) + R"(,"name":"user_)" +
+           std::to_string(i) + R"(","tags":["a","b","c"]})";
+  }
+  ret += "]";
+  return ret;
+}
+
+static std::size_t heap() {
+  auto info = mallinfo2();
+  // 大块内存由mmap分配，不计入uordblks
+  return info.uordblks + info.hblkhd;
+}
+
+static double since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char** argv) {
+  std::size_t mb = argc > 1 ? std::stoul(argv[1]) : 64;
+  std::string path = "/tmp/parser_mapped_file_test.json";
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << generate(mb << 20);
+  }
+
+  auto base = heap();
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::fstream fs(path);
+    std::stringstream sstm;
+    sstm << fs.rdbuf();
+    auto bytes = sstm.str();
+    auto load = since(start);
+    auto used = heap() - base;
+    auto n = parser::Parser::deserialize("json", bytes);
+    std::cout << "stream: load " << load << " ms, heap "
+              << (used >> 20) << " MB, total " << since(start) << " ms"
+              << std::endl;
+  }
+
+  base = heap();
+  {
+    auto start = std::chrono::steady_clock::now();
+    parser::MappedFile file(path);
+    auto load = since(start);
+    auto used = heap() - base;
+    auto n = parser::Parser::deserialize("json", file.view());
+    std::cout << "mmap:   load " << load << " ms, heap " << (used >> 20)
+              << " MB, total " << since(start) << " ms" << std::endl;
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "parser/mapped_file.h"
+#include "parser/parser.h"
+#include "parser/parser_impl.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+
+static std::string writeTemp(const std::string& name,
+                             const std::string& content) {
+  auto path = testing::TempDir() + name;
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs << content;
+  return path;
+}
+
+TEST(MappedFile, Map) {
+  auto path = writeTemp("mapped_file.txt", "hello mapped");
+  parser::MappedFile file(path);
+  ASSERT_TRUE(file.isOpen());
+  EXPECT_TRUE(file.isMapped());
+  EXPECT_EQ(file.view(), "hello mapped");
+
+  // 移动后由新对象持有映射
+  parser::MappedFile other(std::move(file));
+  EXPECT_FALSE(file.isOpen());
+  EXPECT_EQ(other.view(), "hello mapped");
+  unlink(path.c_str());
+}
+
+TEST(MappedFile, Fallback) {
+  // 空文件无法映射
+  auto path = writeTemp("mapped_empty.txt", "");
+  parser::MappedFile empty(path);
+  EXPECT_TRUE(empty.isOpen());
+  EXPECT_FALSE(empty.isMapped());
+  EXPECT_TRUE(empty.view().empty());
+  unlink(path.c_str());
+
+  // procfs文件大小为0，须读到文件末尾
+  parser::MappedFile proc("/proc/self/status");
+  EXPECT_TRUE(proc.isOpen());
+  EXPECT_FALSE(proc.isMapped());
+  EXPECT_NE(proc.view().find("Name:"), std::string_view::npos);
+
+  parser::MappedFile missing("/nonexistent/mapped_file");
+  EXPECT_FALSE(missing.isOpen());
+}
+
+TEST(MappedFile, Read) {
+  auto json = writeTemp("mapped_file.json", R"({"a": [1, 2], "b": "c"})");
+  auto n = parser::Parser::read(json);
+  EXPECT_EQ(n["a"][1].as<int>(), 2);
+  EXPECT_EQ(n["b"].as<std::string>(), "c");
+  unlink(json.c_str());
+
+  auto yaml = writeTemp("mapped_file.yaml", "a: [1, 2]\nb: c\n");
+  auto m = parser::Parser::read(yaml);
+  EXPECT_EQ(m["a"][1].as<int>(), 2);
+  EXPECT_EQ(m["b"].as<std::string>(), "c");
+  unlink(yaml.c_str());
+}
+
+namespace {
+
+// 以const std::string&为参数的后端
+struct Legacy {
+  constexpr static char key[] = "legacy";
+  static std::string serialize(const utils::Node& node) {
+    return node.as<std::string>();
+  }
+  static utils::Node deserialize(const std::string& bytes) {
+    return utils::Node(bytes);
+  }
+};
+
+}  // namespace
+
+TEST(MappedFile, LegacyBackend) {
+  parser::RegisterImpl<Legacy> regist;
+  auto path = writeTemp("mapped_file.legacy", "legacy content");
+  EXPECT_EQ(parser::Parser::read(path).as<std::string>(), "legacy content");
+  EXPECT_EQ(parser::Parser::deserialize("legacy", "abc").as<std::string>(),
+            "abc");
+  unlink(path.c_str());
+}
@@ -0,0 +1,330 @@
+#include "parser/msgpack.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "parser/parser.h"
+
+namespace parser {
+
+namespace {
+
+// 嵌套层数上限，避免不可信的输入耗尽栈空间
+constexpr int kMaxDepth = 1024;
+
+class Encoder {
+ public:
+  explicit Encoder(std::string& buf) : buf_(buf) {}
+
+  void encode(const utils::Node& node) {
+    if (node.isMap()) {
+      header(node.size(), 0x80, 0xde, 0xdf);
+      for (auto iter = node.begin(); iter != node.end(); ++iter) {
+        string(iter->first);
+        encode(iter->second);
+      }
+    } else if (node.isArray()) {
+      header(node.size(), 0x90, 0xdc, 0xdd);
+      for (auto iter = node.begin(); iter != node.end(); ++iter) {
+        encode(*iter);
+      }
+    } else if (node.isBool()) {
+      byte(node.as<bool>() ? 0xc3 : 0xc2);
+    } else if (node.isUnsigned()) {
+      unsignedInt(node.as<uint64_t>());
+    } else if (node.isInteger()) {
+      signedInt(node.as<int64_t>());
+    } else if (node.isDouble()) {
+      auto val = node.as<double>();
+      uint64_t bits;
+      std::memcpy(&bits, &val, sizeof(bits));
+      byte(0xcb);
+      big<uint64_t>(bits);
+    } else if (node.isString()) {
+      string(node.as<std::string>());
+    } else {
+      byte(0xc0);
+    }
+  }
+
+ private:
+  void byte(uint8_t val) { buf_.push_back(static_cast<char>(val)); }
+
+  template <typename T>
+  void big(T val) {
+    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+      byte(static_cast<uint8_t>(val >> shift));
+    }
+  }
+
+  void unsignedInt(uint64_t val) {
+    if (val < 0x80) {
+      byte(static_cast<uint8_t>(val));
+    } else if (val <= UINT8_MAX) {
+      byte(0xcc);
+      big<uint8_t>(static_cast<uint8_t>(val));
+    } else if (val <= UINT16_MAX) {
+      byte(0xcd);
+      big<uint16_t>(static_cast<uint16_t>(val));
+    } else if (val <= UINT32_MAX) {
+      byte(0xce);
+      big<uint32_t>(static_cast<uint32_t>(val));
+    } else {
+      byte(0xcf);
+      big<uint64_t>(val);
+    }
+  }
+
+  void signedInt(int64_t val) {
+    if (val >= 0) {
+      unsignedInt(static_cast<uint64_t>(val));
+    } else if (val >= -32) {
+      byte(static_cast<uint8_t>(val));
+    } else if (val >= INT8_MIN) {
+      byte(0xd0);
+      big<uint8_t>(static_cast<uint8_t>(val));
+    } else if (val >= INT16_MIN) {
+      byte(0xd1);
+      big<uint16_t>(static_cast<uint16_t>(val));
+    } else if (val >= INT32_MIN) {
+      byte(0xd2);
+      big<uint32_t>(static_cast<uint32_t>(val));
+    } else {
+      byte(0xd3);
+      big<uint64_t>(static_cast<uint64_t>(val));
+    }
+  }
+
+  void string(const std::string& str) {
+    auto size = str.size();
+    if (size < 32) {
+      byte(static_cast<uint8_t>(0xa0 | size));
+    } else if (size <= UINT8_MAX) {
+      byte(0xd9);
+      big<uint8_t>(static_cast<uint8_t>(size));
+    } else if (size <= UINT16_MAX) {
+      byte(0xda);
+      big<uint16_t>(static_cast<uint16_t>(size));
+    } else {
+      byte(0xdb);
+      big<uint32_t>(static_cast<uint32_t>(size));
+    }
+    buf_.append(str);
+  }
+
+  // 数组与字典的长度头，fix格式最多15个元素
+  void header(std::size_t size, uint8_t fix, uint8_t b16, uint8_t b32) {
+    if (size < 16) {
+      byte(static_cast<uint8_t>(fix | size));
+    } else if (size <= UINT16_MAX) {
+      byte(b16);
+      big<uint16_t>(static_cast<uint16_t>(size));
+    } else {
+      byte(b32);
+      big<uint32_t>(static_cast<uint32_t>(size));
+    }
+  }
+
+  std::string& buf_;
+};
+
+class Decoder {
+ public:
+  explicit Decoder(std::string_view bytes)
+      : pos_(reinterpret_cast<const uint8_t*>(bytes.data())),
+        end_(pos_ + bytes.size()) {}
+
+  utils::Node decode() {
+    auto b = byte();
+    if (b < 0x80) {
+      return utils::Node(static_cast<int64_t>(b));
+    } else if (b < 0x90) {
+      return map(b & 0x0f);
+    } else if (b < 0xa0) {
+      return array(b & 0x0f);
+    } else if (b < 0xc0) {
+      return utils::Node(string(b & 0x1f));
+    } else if (b >= 0xe0) {
+      return utils::Node(static_cast<int64_t>(static_cast<int8_t>(b)));
+    }
+
+    switch (b) {
+      case 0xc0:
+        return utils::Node();
+      case 0xc2:
+        return utils::Node(false);
+      case 0xc3:
+        return utils::Node(true);
+      case 0xc4:
+        return skip(big<uint8_t>());
+      case 0xc5:
+        return skip(big<uint16_t>());
+      case 0xc6:
+        return skip(big<uint32_t>());
+      case 0xc7:
+        return skip(big<uint8_t>() + 1);
+      case 0xc8:
+        return skip(big<uint16_t>() + 1);
+      case 0xc9:
+        return skip(big<uint32_t>() + 1ull);
+      case 0xca: {
+        auto bits = big<uint32_t>();
+        float val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return utils::Node(static_cast<double>(val));
+      }
+      case 0xcb: {
+        auto bits = big<uint64_t>();
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return utils::Node(val);
+      }
+      case 0xcc:
+        return utils::Node(static_cast<int64_t>(big<uint8_t>()));
+      case 0xcd:
+        return utils::Node(static_cast<int64_t>(big<uint16_t>()));
+      case 0xce:
+        return utils::Node(static_cast<int64_t>(big<uint32_t>()));
+      case 0xcf:
+        return utils::Node(big<uint64_t>());
+      case 0xd0:
+        return utils::Node(static_cast<int64_t>(big<int8_t>()));
+      case 0xd1:
+        return utils::Node(static_cast<int64_t>(big<int16_t>()));
+      case 0xd2:
+        return utils::Node(static_cast<int64_t>(big<int32_t>()));
+      case 0xd3:
+        return utils::Node(big<int64_t>());
+      case 0xd4:
+        return skip(2);
+      case 0xd5:
+        return skip(3);
+      case 0xd6:
+        return skip(5);
+      case 0xd7:
+        return skip(9);
+      case 0xd8:
+        return skip(17);
+      case 0xd9:
+        return utils::Node(string(big<uint8_t>()));
+      case 0xda:
+        return utils::Node(string(big<uint16_t>()));
+      case 0xdb:
+        return utils::Node(string(big<uint32_t>()));
+      case 0xdc:
+        return array(big<uint16_t>());
+      case 0xdd:
+        return array(big<uint32_t>());
+      case 0xde:
+        return map(big<uint16_t>());
+      case 0xdf:
+        return map(big<uint32_t>());
+      default:
+        throw std::runtime_error("msgpack: invalid type byte");
+    }
+  }
+
+  bool finished() const { return pos_ == end_; }
+
+ private:
+  void require(std::size_t size) const {
+    if (static_cast<std::size_t>(end_ - pos_) < size) {
+      throw std::runtime_error("msgpack: unexpected end of input");
+    }
+  }
+
+  uint8_t byte() {
+    require(1);
+    return *pos_++;
+  }
+
+  template <typename T>
+  T big() {
+    require(sizeof(T));
+    std::make_unsigned_t<T> val = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      val = static_cast<std::make_unsigned_t<T>>(val << 8) | *pos_++;
+    }
+    return static_cast<T>(val);
+  }
+
+  std::string string(std::size_t size) {
+    require(size);
+    std::string ret(reinterpret_cast<const char*>(pos_), size);
+    pos_ += size;
+    return ret;
+  }
+
+  utils::Node skip(std::size_t size) {
+    require(size);
+    pos_ += size;
+    return utils::Node();
+  }
+
+  void enter() {
+    if (++depth_ > kMaxDepth) {
+      throw std::runtime_error("msgpack: nesting too deep");
+    }
+  }
+
+  utils::Node array(std::size_t size) {
+    // 每个元素至少占一个字节，长度不可信时不预先分配
+    require(size);
+    enter();
+    auto n = utils::Node::makeArray();
+    for (std::size_t i = 0; i < size; ++i) {
+      n.push_back(decode());
+    }
+    --depth_;
+    return n;
+  }
+
+  utils::Node map(std::size_t size) {
+    require(size * 2);
+    enter();
+    auto n = utils::Node::makeMap();
+    for (std::size_t i = 0; i < size; ++i) {
+      auto b = byte();
+      std::string key;
+      if (b >= 0xa0 && b < 0xc0) {
+        key = string(b & 0x1f);
+      } else if (b == 0xd9) {
+        key = string(big<uint8_t>());
+      } else if (b == 0xda) {
+        key = string(big<uint16_t>());
+      } else if (b == 0xdb) {
+        key = string(big<uint32_t>());
+      } else {
+        throw std::runtime_error("msgpack: map key must be a string");
+      }
+      n[key] = decode();
+    }
+    --depth_;
+    return n;
+  }
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+  int depth_ = 0;
+};
+
+}  // namespace
+
+utils::Node MsgPack::deserialize(std::string_view bytes) {
+  Decoder decoder(bytes);
+  auto n = decoder.decode();
+  if (!decoder.finished()) {
+    throw std::runtime_error("msgpack: trailing bytes");
+  }
+  return n;
+}
+
+std::string MsgPack::serialize(const utils::Node& node) {
+  std::string buf;
+  Encoder(buf).encode(node);
+  return buf;
+}
+
+REGIST_PARSER(MsgPack)
+
+}  // namespace parser
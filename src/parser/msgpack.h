@@ -0,0 +1,23 @@
+#pragma once
+
+#include "parser/parser_impl.h"
+#include "utils/meta.hpp"
+
+namespace parser {
+
+/**
+ * @brief
+ * MessagePack二进制格式，用于进程、机器间传输utils::Node。
+ * 序列化一次遍历写入同一缓冲区，反序列化直接构造utils::Node。
+ * 空值对应nil，bin与ext类型解析为空节点，字典的键须为字符串
+ */
+class MsgPack {
+ public:
+  MsgPack() = default;
+
+  constexpr static char key[] = "msgpack";
+  static utils::Node deserialize(std::string_view);
+  static std::string serialize(const utils::Node&);
+};
+
+}  // namespace parser
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "parser/parser.h"
+#include "utils/meta.hpp"
+
+// MessagePack与JSON对比：./parser.msgpack_test [配置文件...]
+// 对每个文件统计两种格式的大小与单次编码、解码耗时，
+// 未指定文件时使用生成的模块清单与记录数组
+
+static utils::Node manifest(int modules) {
+  utils::Node n;
+  for (int i = 0; i < modules; ++i) {
+    utils::Node m;
+    m["name"] = "module_" + std::to_string(i);
+    m["path"] = "/opt/phoenix/lib/libmodule_" + std::to_string(i) + ".so";
+    m["enabled"] = i % 3 != 0;
+    m["priority"] = i;
+    m["timeout"] = 1.5 * i;
+    for (int d = 1; d <= 3 && d <= i; ++d) {
+      m["depends"].push_back("module_" + std::to_string(i - d));
+    }
+    n["modules"].push_back(m);
+  }
+  return n;
+}
+
+static utils::Node records(int count) {
+  utils::Node n = utils::Node::makeArray();
+  for (int i = 0; i < count; ++i) {
+    utils::Node r;
+    r["id"] = static_cast<int64_t>(i) * 1000003;
+    r["name"] = "user_" + std::to_string(i);
+    r["score"] = i * 0.25;
+    r["active"] = true;
+    r["pos"]["x"] = 1.5;
+    r["pos"]["y"] = -2;
+    n.push_back(r);
+  }
+  return n;
+}
+
+// 单次耗时(ms)
+template <typename F>
+static double measure(F&& f) {
+  // 重复到至少100ms
+  int rounds = 0;
+  auto start = std::chrono::steady_clock::now();
+  double cost = 0;
+  do {
+    f();
+    ++rounds;
+    cost = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+               .count();
+  } while (cost < 0.1);
+  return cost * 1000 / rounds;
+}
+
+static void compare(const std::string& name, const utils::Node& node) {
+  std::cout << name << std::endl;
+  for (auto format : {"json", "msgpack"}) {
+    auto bytes = parser::Parser::serialize(format, node);
+    auto enc = measure([&node, format]() {
+      return parser::Parser::serialize(format, node);
+    });
+    auto dec = measure([&bytes, format]() {
+      return parser::Parser::deserialize(format, bytes);
+    });
+    std::cout << "  " << format << ": " << bytes.size() << " bytes, encode "
+              << enc << " ms, decode " << dec << " ms" << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) {
+      compare(argv[i], parser::Parser::read(argv[i]));
+    }
+    return 0;
+  }
+
+  compare("manifest(200 modules)", manifest(200));
+  compare("records(20000)", records(20000));
+  return 0;
+}
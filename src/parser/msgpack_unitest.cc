@@ -0,0 +1,70 @@
+#include "utils/meta.hpp"
+#include "parser/parser.h"
+
+#include <gtest/gtest.h>
+
+TEST(MsgPack, Encode) {
+  utils::Node n;
+  n["a"] = 1;
+  // {"a": 1}
+  EXPECT_EQ(parser::Parser::serialize("msgpack", n), "\x81\xa1" "a\x01");
+
+  utils::Node arr;
+  arr.push_back(-1);
+  arr.push_back(-33);
+  arr.push_back(200);
+  arr.push_back(true);
+  arr.push_back(utils::Node());
+  EXPECT_EQ(parser::Parser::serialize("msgpack", arr),
+            std::string("\x95\xff\xd0\xdf\xcc\xc8\xc3\xc0", 8));
+}
+
+TEST(MsgPack, RoundTrip) {
+  utils::Node n;
+  n["bool"] = false;
+  n["int"] = INT64_MIN;
+  n["uint"] = UINT64_MAX;
+  n["u32"] = static_cast<int64_t>(UINT32_MAX);
+  n["i16"] = -30000;
+  n["double"] = 0.1;
+  n["string"] = std::string(300, 'x');
+  n["empty_map"] = utils::Node::makeMap();
+  n["empty_array"] = utils::Node::makeArray();
+  n["null"] = utils::Node();
+  for (int i = 0; i < 70000; ++i) {
+    n["array"].push_back(i);
+  }
+
+  auto bytes = parser::Parser::serialize("msgpack", n);
+  auto m = parser::Parser::deserialize("msgpack", bytes);
+  EXPECT_EQ(m.size(), n.size());
+  EXPECT_EQ(m["bool"].as<bool>(), false);
+  EXPECT_EQ(m["int"].as<int64_t>(), INT64_MIN);
+  EXPECT_TRUE(m["uint"].isUnsigned());
+  EXPECT_EQ(m["uint"].as<uint64_t>(), UINT64_MAX);
+  EXPECT_EQ(m["u32"].as<int64_t>(), UINT32_MAX);
+  EXPECT_EQ(m["i16"].as<int>(), -30000);
+  EXPECT_EQ(m["double"].as<double>(), 0.1);
+  EXPECT_EQ(m["string"].as<std::string>(), std::string(300, 'x'));
+  EXPECT_TRUE(m["empty_map"].isMap());
+  EXPECT_TRUE(m["empty_array"].isArray());
+  EXPECT_FALSE(m["null"].isValid());
+  ASSERT_EQ(m["array"].size(), 70000u);
+  EXPECT_EQ(m["array"][69999].as<int>(), 69999);
+}
+
+TEST(MsgPack, Invalid) {
+  // 截断的输入
+  EXPECT_ANY_THROW(parser::Parser::deserialize("msgpack", "\x92\x01"));
+  EXPECT_ANY_THROW(parser::Parser::deserialize("msgpack", "\xa5" "ab"));
+  // 非字符串的键
+  EXPECT_ANY_THROW(parser::Parser::deserialize("msgpack", "\x81\x01\x01"));
+  // 多余的字节
+  EXPECT_ANY_THROW(parser::Parser::deserialize("msgpack", "\x01\x02"));
+  // 过深的嵌套
+  EXPECT_ANY_THROW(
+      parser::Parser::deserialize("msgpack", std::string(1 << 20, '\x91')));
+  std::string nested(1024, '\x91');
+  nested += '\x01';
+  EXPECT_NO_THROW(parser::Parser::deserialize("msgpack", nested));
+}
@@ -1,13 +1,13 @@
 #include "parser/parser.h"
 
 #include <fstream>
-#include <sstream>
+#include "parser/mapped_file.h"
 #include "parser/parser_impl.h"
 
 namespace parser {
 
 utils::Node Parser::deserialize(const std::string& format,
-                                const std::string& bytes) {
+                                std::string_view bytes) {
   //
   return ParserInst::instance().deserialize(format, bytes);
 }
@@ -25,10 +25,8 @@ utils::Node Parser::read(const std::string& file) {
   }
 
   auto key = file.substr(pos + 1);
-  std::fstream fs(file);
-  std::stringstream sstm;
-  sstm << fs.rdbuf();
-  return parser::ParserInst::instance().deserialize(key, sstm.str());
+  MappedFile mapped(file);
+  return parser::ParserInst::instance().deserialize(key, mapped.view());
 }
 
 bool Parser::write(const std::string& file, utils::Node& node) {
@@ -57,7 +55,8 @@ void ParserImpl::registFuncs(const std::string& key,
 }
 
 utils::Node ParserImpl::deserialize(const std::string& key,
-                                    const std::string& bytes) {
+                                    std::string_view bytes) {
+  materialize<ParserImpl>();
   if (deser_funcs_.count(key) == 1) {
     return deser_funcs_[key](bytes);
   }
@@ -65,6 +64,7 @@ utils::Node ParserImpl::deserialize(const std::string& key,
 }
 std::string ParserImpl::serialize(const std::string& key,
                                   const utils::Node& node) {
+  materialize<ParserImpl>();
   if (ser_funcs_.count(key) == 1) {
     return ser_funcs_[key](node);
   }
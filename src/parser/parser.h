@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string_view>
+
 #include "utils/meta.hpp"
 
 namespace parser {
@@ -9,11 +11,18 @@ class Parser {
   Parser() = default;
 
   static utils::Node deserialize(const std::string& format,
-                                 const std::string& bytes);
+                                 std::string_view bytes);
   static std::string serialize(const std::string& format,
                                const utils::Node& node);
 
+  /**
+   * @brief
+   * 文件以只读方式映射后直接交给后端解析，读取过程不复制文件内容。
+   * 解析期间文件被截断(如其他线程或进程对同一路径调用write)时，
+   * 访问截断部分的页面会触发SIGBUS，而不是读到不完整的内容
+   */
   static utils::Node read(const std::string& file);
+  // 原地截断后写入，不应与对同一文件的read并发
   static bool write(const std::string& file, utils::Node& node);
 };
 
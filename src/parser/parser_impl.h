@@ -1,7 +1,11 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include "utils/factory/class_register.hpp"
+#include "utils/factory/lazy_register.hpp"
 #include "utils/macros.hpp"
 #include "utils/meta.hpp"
 #include "utils/noncopyable.hpp"
@@ -13,14 +17,27 @@ namespace parser {
 class ParserImpl : public noncopyable, public nonmovable {
  public:
   using SerializeFunc = std::function<std::string(const utils::Node&)>;
-  using DeserializeFunc = std::function<utils::Node(const std::string&)>;
+  // 反序列化的输入可能直接指向映射的文件，后端不得在返回后持有
+  using DeserializeFunc = std::function<utils::Node(std::string_view)>;
   ParserImpl() = default;
 
+  // 兼容以const std::string&为参数的后端，输入复制为std::string后调用
+  template <typename F>
+  static DeserializeFunc adapt(F func) {
+    if constexpr (std::is_invocable_r_v<utils::Node, F, std::string_view>) {
+      return func;
+    } else {
+      return [func](std::string_view bytes) {
+        return func(std::string(bytes));
+      };
+    }
+  }
+
   void registFuncs(const std::string& key,
                    const SerializeFunc& ser,
                    const DeserializeFunc& deser);
 
-  utils::Node deserialize(const std::string& key, const std::string& bytes);
+  utils::Node deserialize(const std::string& key, std::string_view bytes);
   std::string serialize(const std::string& key, const utils::Node& node);
 
  private:
@@ -34,18 +51,23 @@ template <typename T>
 class RegisterImpl {
  public:
   RegisterImpl() {
-    ParserInst::instance().registFuncs(T::key, T::serialize, T::deserialize);
+    ParserInst::instance().registFuncs(T::key, T::serialize,
+                                       ParserImpl::adapt(T::deserialize));
   }
 };
 
-#define REGIST_PARSER(cls)                                         \
-  class CONCAT(cls, Register) {                                    \
-   public:                                                         \
-    CONCAT(cls, Register)() {                                      \
-      ParserInst::instance().registFuncs(cls::key, cls::serialize, \
-                                         cls::deserialize);        \
-    }                                                              \
-  };                                                               \
-  static CONCAT(cls, Register) CONCAT(s_reg_, __COUNTER__);
+/**
+ * @brief
+ * 首次序列化/反序列化时才注册。插件中的后端同样如此，
+ * 插件在首次查询之后才加载时则在加载时立即注册。
+ * cls::deserialize可接受std::string_view或const std::string&，
+ * 后者每次调用多复制一次输入
+ */
+#define REGIST_PARSER(cls)                                              \
+  static void CONCAT(cls, Install)() {                                  \
+    ParserInst::instance().registFuncs(                                 \
+        cls::key, cls::serialize, ParserImpl::adapt(cls::deserialize)); \
+  }                                                                     \
+  LAZY_REGISTER(ParserImpl, CONCAT(cls, Install))
 
 }  // namespace parser
\ No newline at end of file
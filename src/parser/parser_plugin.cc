@@ -0,0 +1,27 @@
+#include "parser/parser_impl.h"
+
+#ifndef PLUGIN_KEY
+#define PLUGIN_KEY "plugin"
+#endif
+
+namespace parser {
+
+namespace {
+
+// 由插件注册的后端，内容按字符串原样读写
+class PluginParser {
+ public:
+  constexpr static char key[] = PLUGIN_KEY;
+  static std::string serialize(const utils::Node& node) {
+    return node.as<std::string>();
+  }
+  static utils::Node deserialize(std::string_view bytes) {
+    return utils::Node(std::string(bytes));
+  }
+};
+
+}  // namespace
+
+REGIST_PARSER(PluginParser)
+
+}  // namespace parser
@@ -0,0 +1,24 @@
+#include <dlfcn.h>
+#include <gtest/gtest.h>
+
+#include "parser/parser.h"
+
+// 各用例由ctest在单独的进程中运行，整体运行时也按定义顺序成立
+
+// 首次查询前加载的插件，其注册项在查询时与本库的一同安装
+TEST(ParserPlugin, LoadedBeforeQuery) {
+  auto handle = dlopen(PARSER_PLUGIN, RTLD_NOW | RTLD_LOCAL);
+  ASSERT_NE(handle, nullptr) << dlerror();
+  EXPECT_EQ(parser::Parser::deserialize("plugin", "abc").as<std::string>(),
+            "abc");
+  EXPECT_EQ(parser::Parser::deserialize("json", "[1]")[0].as<int>(), 1);
+}
+
+// 查询之后加载的插件在加载时立即安装
+TEST(ParserPlugin, LoadedAfterQuery) {
+  EXPECT_EQ(parser::Parser::deserialize("json", "[1]")[0].as<int>(), 1);
+  auto handle = dlopen(PARSER_PLUGIN_V2, RTLD_NOW | RTLD_LOCAL);
+  ASSERT_NE(handle, nullptr) << dlerror();
+  EXPECT_EQ(
+      parser::Parser::serialize("plugin_v2", utils::Node("xyz")), "xyz");
+}
@@ -0,0 +1,356 @@
+#include "parser/push_parser.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "parser/json.h"
+#include "parser/yaml.h"
+
+namespace parser {
+
+namespace {
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+enum : uint8_t {
+  kNone = 0,
+  kQuote,
+  kOpen,
+  kClose,
+  // ',' ':'
+  kSeparator,
+};
+
+struct Table {
+  constexpr Table() : cls_() {
+    cls_[static_cast<uint8_t>('"')] = kQuote;
+    cls_[static_cast<uint8_t>('[')] = kOpen;
+    cls_[static_cast<uint8_t>('{')] = kOpen;
+    cls_[static_cast<uint8_t>(']')] = kClose;
+    cls_[static_cast<uint8_t>('}')] = kClose;
+    cls_[static_cast<uint8_t>(',')] = kSeparator;
+    cls_[static_cast<uint8_t>(':')] = kSeparator;
+  }
+  uint8_t cls_[256];
+};
+
+constexpr Table kTable;
+
+void fail(std::exception_ptr& error, std::exception_ptr e) {
+  if (!error) {
+    error = e;
+  }
+}
+
+uint8_t classOf(char c) {
+  return kTable.cls_[static_cast<uint8_t>(c)];
+}
+
+// 超过此容量的缓冲区在交出值后释放，避免单个大值长期占用内存
+constexpr std::size_t kKeepCapacity = 64 << 10;
+
+void release(std::string& buffer) {
+  if (buffer.capacity() > kKeepCapacity) {
+    std::string().swap(buffer);
+  } else {
+    buffer.clear();
+  }
+}
+
+bool isMarker(std::string_view line, std::string_view marker) {
+  return line.substr(0, 3) == marker &&
+         (line.size() == 3 || isSpace(line[3]));
+}
+
+// 行中有注释之外的内容
+bool hasContent(std::string_view line) {
+  auto iter = std::find_if_not(line.begin(), line.end(), isSpace);
+  return iter != line.end() && *iter != '#';
+}
+
+}  // namespace
+
+std::unique_ptr<PushParser> PushParser::create(const std::string& format,
+                                               const Callback& callback) {
+  if (format == Json::key) {
+    return std::make_unique<JsonPushParser>(callback);
+  }
+  if (format == Yaml::key) {
+    return std::make_unique<YamlPushParser>(callback);
+  }
+  return nullptr;
+}
+
+void JsonPushParser::feed(std::string_view bytes) {
+  // 本段中第一个错误，处理完整段输入后抛出
+  std::exception_ptr error;
+  // 当前值在bytes中的起点，延续上一段的值时为0
+  std::size_t start = 0;
+  std::size_t i = 0;
+  auto size = bytes.size();
+
+  while (i < size) {
+    switch (state_) {
+      case State::Idle: {
+        auto c = bytes[i];
+        if (isSpace(c)) {
+          ++i;
+          continue;
+        }
+        start = i++;
+        switch (classOf(c)) {
+          case kOpen:
+            state_ = State::Value;
+            depth_ = 1;
+            break;
+          case kQuote:
+            state_ = State::Value;
+            depth_ = 0;
+            in_string_ = true;
+            break;
+          case kNone:
+            state_ = State::Scalar;
+            break;
+          default:
+            // 跳过该字符
+            fail(error, std::make_exception_ptr(std::invalid_argument(
+                            std::string("json: unexpected '") + c + "'")));
+        }
+      } break;
+
+      case State::Scalar:
+        while (i < size && !isSpace(bytes[i]) && classOf(bytes[i]) == kNone) {
+          ++i;
+        }
+        // 结束字符属于下一个值
+        if (i < size) {
+          emit(bytes.substr(start, i - start), error);
+        }
+        break;
+
+      case State::Value:
+        if (in_string_) {
+          for (; i < size; ++i) {
+            if (escape_) {
+              escape_ = false;
+            } else if (bytes[i] == '\\') {
+              escape_ = true;
+            } else if (bytes[i] == '"') {
+              in_string_ = false;
+              ++i;
+              break;
+            }
+          }
+          if (!in_string_ && depth_ == 0) {
+            emit(bytes.substr(start, i - start), error);
+          }
+          break;
+        }
+        switch (classOf(bytes[i++])) {
+          case kQuote:
+            in_string_ = true;
+            break;
+          case kOpen:
+            ++depth_;
+            break;
+          case kClose:
+            if (--depth_ == 0) {
+              emit(bytes.substr(start, i - start), error);
+            }
+            break;
+          default:
+            break;
+        }
+        break;
+    }
+  }
+
+  if (state_ != State::Idle && !discard_) {
+    if (exceeds(buffer_.size() + size - start)) {
+      // 继续跟踪该值的结构直到其结束，内容不再缓存
+      discard_ = true;
+      release(buffer_);
+      fail(error, std::make_exception_ptr(std::length_error(
+                      "json: value exceeds the buffer limit")));
+    } else {
+      buffer_.append(bytes.substr(start));
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void JsonPushParser::finish() {
+  if (state_ == State::Scalar) {
+    std::exception_ptr error;
+    emit(std::string_view(), error);
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  } else if (state_ != State::Idle) {
+    reset();
+    throw std::invalid_argument("json: unexpected end of input");
+  }
+}
+
+void JsonPushParser::reset() {
+  state_ = State::Idle;
+  depth_ = 0;
+  in_string_ = false;
+  escape_ = false;
+  discard_ = false;
+  release(buffer_);
+}
+
+// value为值在本段中的部分，之前各段的部分在buffer_中
+void JsonPushParser::emit(std::string_view value, std::exception_ptr& error) {
+  // 超过缓存上限的值已报告过错误
+  if (discard_) {
+    reset();
+    return;
+  }
+  utils::Node node;
+  try {
+    if (buffer_.empty()) {
+      node = Json::deserialize(value);
+    } else {
+      if (exceeds(buffer_.size() + value.size())) {
+        throw std::length_error("json: value exceeds the buffer limit");
+      }
+      buffer_.append(value);
+      node = Json::deserialize(buffer_);
+    }
+  } catch (...) {
+    fail(error, std::current_exception());
+    reset();
+    return;
+  }
+  reset();
+  callback_(node);
+}
+
+void YamlPushParser::feed(std::string_view bytes) {
+  std::exception_ptr error;
+  buffer_.append(bytes);
+  scan(false, error);
+  limit(error);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void YamlPushParser::finish() {
+  std::exception_ptr error;
+  scan(true, error);
+  if (content_ && !discard_) {
+    emit(buffer_.size(), error);
+  }
+  reset();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void YamlPushParser::reset() {
+  release(buffer_);
+  line_ = 0;
+  started_ = false;
+  content_ = false;
+  discard_ = false;
+  skip_line_ = false;
+}
+
+// 逐行检查已完整到达的行，eof时末尾不完整的行也参与检查
+void YamlPushParser::scan(bool eof, std::exception_ptr& error) {
+  while (line_ < buffer_.size()) {
+    auto nl = buffer_.find('\n', line_);
+    if (nl == std::string::npos) {
+      if (!eof) {
+        break;
+      }
+      nl = buffer_.size();
+    }
+    std::string_view line(buffer_.data() + line_, nl - line_);
+    auto next = std::min(nl + 1, buffer_.size());
+    auto skipped = skip_line_;
+    skip_line_ = false;
+
+    // 移出buffer_开头的count个字节，line_在本行结束时更新
+    auto shift = [this, &next](std::size_t count) {
+      buffer_.erase(0, count);
+      next -= count;
+    };
+
+    if (skipped) {
+      // 被丢弃的超长行的剩余部分，所在文档已被丢弃
+    } else if (isMarker(line, "---")) {
+      auto content = hasContent(line.substr(3));
+      if (content_ && !discard_) {
+        emit(line_, error);
+        shift(line_);
+      } else if (started_ || discard_) {
+        // 跳过空文档与超过上限的文档，此前只有指令与注释时保留，
+        // 与本行一起属于新文档
+        shift(line_);
+      }
+      started_ = true;
+      content_ = content;
+      discard_ = false;
+    } else if (isMarker(line, "...")) {
+      if (content_ && !discard_) {
+        emit(line_, error);
+      }
+      shift(next);
+      started_ = false;
+      content_ = false;
+      discard_ = false;
+    } else if (hasContent(line) && line[0] != '%') {
+      content_ = true;
+    }
+    line_ = next;
+  }
+
+  // 被丢弃的文档的行检查完即移出
+  if (discard_) {
+    buffer_.erase(0, line_);
+    line_ = 0;
+  }
+}
+
+// 未交出的文档超过缓存上限时丢弃，直到下一个文档开始
+void YamlPushParser::limit(std::exception_ptr& error) {
+  if (!exceeds(buffer_.size())) {
+    return;
+  }
+  if (!discard_) {
+    fail(error, std::make_exception_ptr(std::length_error(
+                    "yaml: document exceeds the buffer limit")));
+  }
+  discard_ = true;
+  content_ = false;
+  buffer_.erase(0, line_);
+  line_ = 0;
+  // 剩余的是一个不完整的行，超过上限时同样丢弃，不再检查其是否为文档标记
+  if (exceeds(buffer_.size())) {
+    release(buffer_);
+    skip_line_ = true;
+  }
+}
+
+void YamlPushParser::emit(std::size_t end, std::exception_ptr& error) {
+  utils::Node node;
+  try {
+    node = Yaml::deserialize(std::string_view(buffer_.data(), end));
+  } catch (...) {
+    fail(error, std::current_exception());
+    content_ = false;
+    return;
+  }
+  content_ = false;
+  callback_(node);
+}
+
+}  // namespace parser
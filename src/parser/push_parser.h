@@ -0,0 +1,140 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "utils/meta.hpp"
+#include "utils/noncopyable.hpp"
+
+namespace parser {
+
+/**
+ * @brief
+ * 增量解析分段到达的输入，每个顶层值闭合时立即解析并通过回调交出。
+ * 只缓存跨越分段的未完成值，完整落在一段输入中的值直接在该段上解析，
+ * 适合在套接字、管道的读事件中逐段调用feed。
+ * 某个值解析失败或超过缓存上限时跳过该值，其后的值照常交出，
+ * 本段输入处理完后抛出其中第一个错误，无需reset()即可继续feed。
+ * 回调抛出的异常直接传出，本段剩余的输入被丢弃。
+ *
+ * e.g.
+ * auto parser = parser::PushParser::create("json", [](utils::Node& value) {
+ *   ...
+ * });
+ * thd->addEvent(fd, core::Events::ReadOnly, [&](const core::Event*) {
+ *   auto n = ::read(fd, buf, sizeof(buf));
+ *   n > 0 ? parser->feed(std::string_view(buf, n)) : parser->finish();
+ * });
+ */
+class PushParser : public noncopyable {
+ public:
+  using Callback = std::function<void(utils::Node& value)>;
+
+  explicit PushParser(const Callback& callback) : callback_(callback) {}
+  virtual ~PushParser() = default;
+
+  // bytes在返回后即可释放
+  virtual void feed(std::string_view bytes) = 0;
+  // 输入结束，交出末尾的值，输入在值的中间结束时抛出
+  virtual void finish() = 0;
+  // 丢弃未完成的值
+  virtual void reset() = 0;
+  // 为未完成的值缓存的字节数
+  virtual std::size_t buffered() const = 0;
+
+  /**
+   * @brief
+   * 跨越分段的值最多缓存的字节数，0为不限制。
+   * 超过时丢弃该值并抛出std::length_error，之后的值不受影响
+   */
+  void setMaxBuffered(std::size_t bytes) { max_buffered_ = bytes; }
+
+  // 支持json与yaml，其他格式返回nullptr
+  static std::unique_ptr<PushParser> create(const std::string& format,
+                                            const Callback& callback);
+
+ protected:
+  bool exceeds(std::size_t size) const {
+    return max_buffered_ != 0 && size > max_buffered_;
+  }
+
+  Callback callback_;
+  std::size_t max_buffered_ = 0;
+};
+
+/**
+ * @brief
+ * 顶层值之间以空白分隔，如NDJSON或连续发送的JSON文档。
+ * 分段时只跟踪字符串、转义与嵌套深度，值本身由Json::deserialize检查。
+ * 顶层的数字与true/false/null在遇到其后的空白或下一个值时才算结束，
+ * 输入末尾的此类值由finish()交出
+ */
+class JsonPushParser : public PushParser {
+ public:
+  explicit JsonPushParser(const Callback& callback) : PushParser(callback) {}
+
+  void feed(std::string_view bytes) override;
+  void finish() override;
+  void reset() override;
+  std::size_t buffered() const override { return buffer_.size(); }
+
+ private:
+  enum class State {
+    // 顶层值之间
+    Idle,
+    // 容器或字符串
+    Value,
+    // 数字与true/false/null
+    Scalar,
+  };
+
+  // 解析失败时将错误记入error
+  void emit(std::string_view value, std::exception_ptr& error);
+
+  State state_ = State::Idle;
+  int depth_ = 0;
+  bool in_string_ = false;
+  bool escape_ = false;
+  // 当前值超过缓存上限，只跟踪结构直到其结束
+  bool discard_ = false;
+  std::string buffer_;
+};
+
+/**
+ * @brief
+ * 以行首的"---"与"..."划分文档，下一个文档开始、"..."或finish()时交出当前文档。
+ * yaml-cpp不支持增量解析，单个文档在交出前整体缓存。
+ * 没有内容的文档被跳过，"---"之前的指令与注释归入其后的文档
+ */
+class YamlPushParser : public PushParser {
+ public:
+  explicit YamlPushParser(const Callback& callback) : PushParser(callback) {}
+
+  void feed(std::string_view bytes) override;
+  void finish() override;
+  void reset() override;
+  std::size_t buffered() const override { return buffer_.size(); }
+
+ private:
+  void scan(bool eof, std::exception_ptr& error);
+  void limit(std::exception_ptr& error);
+  // 交出buffer_中[0, end)的文档，由调用者移出
+  void emit(std::size_t end, std::exception_ptr& error);
+
+  std::string buffer_;
+  // buffer_中下一个未检查的行
+  std::size_t line_ = 0;
+  // 当前文档已有"---"
+  bool started_ = false;
+  // 当前文档有指令与注释之外的内容
+  bool content_ = false;
+  // 当前文档超过缓存上限，直到下一个文档开始前的行都被丢弃
+  bool discard_ = false;
+  // buffer_开头是被丢弃的超长行的剩余部分
+  bool skip_line_ = false;
+};
+
+}  // namespace parser
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "parser/parser.h"
+#include "parser/push_parser.h"
+
+// 增量解析测试：./parser.push_parser_test [输入大小(MB)，默认32] [每次读取的字节数，默认4096]
+// 模拟从套接字分段读取NDJSON，对比整体缓存后解析与逐段feed的
+// 吞吐、首个值的延迟与缓存占用
+
+using Clock = std::chrono::steady_clock;
+
+static double ms(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from)
+      .count();
+}
+
+int main(int argc, char** argv) {
+  std::size_t size = (argc > 1 ? std::stoul(argv[1]) : 32) << 20;
+  std::size_t step = argc > 2 ? std::stoul(argv[2]) : 4096;
+  std::string input;
+  for (int64_t i = 0; input.size() < size; ++i) {
+    input += R"({"seq":)" + std::to_string(i) +
+             R"(,"topic":"sensor/)" + std::to_string(i % 64) +
+             R"(","payload":{"value":)" + std::to_string(i * 0.5) +
+             R"(,"tags":["a","b\"c"]}})" + "\n";
+  }
+  auto mb = static_cast<double>(input.size()) / (1 << 20);
+
+  {
+    auto start = Clock::now();
+    std::string message;
+    for (std::size_t i = 0; i < input.size(); i += step) {
+      message.append(input, i, step);
+    }
+    double first = 0;
+    std::size_t count = 0;
+    std::string_view rest(message);
+    while (!rest.empty()) {
+      auto nl = rest.find('\n');
+      parser::Parser::deserialize("json", rest.substr(0, nl));
+      if (count++ == 0) {
+        first = ms(start);
+      }
+      rest.remove_prefix(nl == std::string_view::npos ? rest.size() : nl + 1);
+    }
+    auto cost = ms(start);
+    std::cout << "buffered: " << count << " values, " << mb / cost * 1000
+              << " MB/s, first value after " << first << " ms, buffer "
+              << message.capacity() / 1024 << " KB" << std::endl;
+  }
+
+  {
+    auto start = Clock::now();
+    double first = 0;
+    std::size_t count = 0;
+    std::size_t peak = 0;
+    parser::JsonPushParser parser(
+        [&count, &first, start](utils::Node&) {
+          if (count++ == 0) {
+            first = ms(start);
+          }
+        });
+    for (std::size_t i = 0; i < input.size(); i += step) {
+      parser.feed(std::string_view(input).substr(i, step));
+      peak = std::max(peak, parser.buffered());
+    }
+    parser.finish();
+    auto cost = ms(start);
+    std::cout << "push:     " << count << " values, " << mb / cost * 1000
+              << " MB/s, first value after " << first << " ms, buffer "
+              << peak / 1024.0 << " KB" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include "parser/push_parser.h"
+#include "parser/parser.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+// 按step字节分段输入，返回交出的值序列化为json的结果
+static std::vector<std::string> feed(const std::string& format,
+                                     std::string_view bytes,
+                                     std::size_t step) {
+  std::vector<std::string> ret;
+  auto parser = parser::PushParser::create(format, [&ret](utils::Node& value) {
+    ret.push_back(parser::Parser::serialize("json", value));
+  });
+  for (std::size_t i = 0; i < bytes.size(); i += step) {
+    parser->feed(bytes.substr(i, step));
+  }
+  parser->finish();
+  EXPECT_EQ(parser->buffered(), 0u);
+  return ret;
+}
+
+TEST(PushParser, Json) {
+  std::string doc = R"({"id": 1, "s": "}]\"{[\\"}
+[1, [2, {"x": []}], "]"]
+  "top\"level"  -12.5e3 true
+null{"a":{}}[]"x"7)";
+  std::vector<std::string> expected = {
+      parser::Parser::serialize(
+          "json", parser::Parser::deserialize(
+                      "json", R"({"id": 1, "s": "}]\"{[\\"})")),
+      parser::Parser::serialize(
+          "json", parser::Parser::deserialize(
+                      "json", R"([1, [2, {"x": []}], "]"])")),
+      R"("top\"level")",
+      "-12500.0",
+      "true",
+      "null",
+      R"({"a":{}})",
+      "[]",
+      R"("x")",
+      "7",
+  };
+  for (std::size_t step : {1, 2, 3, 7, 64, 4096}) {
+    EXPECT_EQ(feed("json", doc, step), expected) << step;
+  }
+}
+
+TEST(PushParser, JsonPartial) {
+  std::vector<int> values;
+  parser::JsonPushParser parser(
+      [&values](utils::Node& value) { values.push_back(value["v"].as<int>()); });
+
+  parser.feed(R"({"v": 1}{"v")");
+  EXPECT_EQ(values, std::vector<int>({1}));
+  EXPECT_EQ(parser.buffered(), 4u);
+  parser.feed(R"(: 2})");
+  EXPECT_EQ(values, std::vector<int>({1, 2}));
+  EXPECT_EQ(parser.buffered(), 0u);
+
+  // 顶层数字在遇到之后的字符或输入结束时才完整
+  std::vector<int64_t> numbers;
+  parser::JsonPushParser scalar(
+      [&numbers](utils::Node& value) { numbers.push_back(value.as<int64_t>()); });
+  scalar.feed("12");
+  scalar.feed("34");
+  EXPECT_TRUE(numbers.empty());
+  scalar.feed(" 5");
+  EXPECT_EQ(numbers, std::vector<int64_t>({1234}));
+  scalar.finish();
+  EXPECT_EQ(numbers, std::vector<int64_t>({1234, 5}));
+}
+
+TEST(PushParser, JsonInvalid) {
+  int count = 0;
+  parser::JsonPushParser parser([&count](utils::Node&) { ++count; });
+
+  EXPECT_THROW(parser.feed("{} ]"), std::invalid_argument);
+  EXPECT_EQ(count, 1);
+  EXPECT_THROW(parser.feed(R"({"a": })"), std::invalid_argument);
+  EXPECT_THROW(parser.feed("tru "), std::invalid_argument);
+  EXPECT_EQ(count, 1);
+
+  // 出错后从新的值开始
+  parser.feed(R"([1] {"a": ")");
+  EXPECT_EQ(count, 2);
+  EXPECT_THROW(parser.finish(), std::invalid_argument);
+  EXPECT_EQ(parser.buffered(), 0u);
+  parser.feed("{}");
+  EXPECT_EQ(count, 3);
+}
+
+TEST(PushParser, JsonRecover) {
+  std::vector<std::string> values;
+  parser::JsonPushParser parser([&values](utils::Node& value) {
+    values.push_back(parser::Parser::serialize("json", value));
+  });
+
+  // 出错的值被跳过，本段其余的输入与未完成的值照常处理
+  EXPECT_THROW(parser.feed(R"({"a":} ] {"b":[1,)"), std::invalid_argument);
+  EXPECT_TRUE(values.empty());
+  parser.feed("2]}\n{\"c\":3}\n");
+  EXPECT_EQ(values, std::vector<std::string>({R"({"b":[1,2]})", R"({"c":3})"}));
+}
+
+TEST(PushParser, Limit) {
+  std::vector<std::string> values;
+  auto collect = [&values](utils::Node& value) {
+    values.push_back(parser::Parser::serialize("json", value));
+  };
+
+  // 落在一段之内的值不受限制，跨段的值超过上限时被丢弃
+  parser::JsonPushParser json(collect);
+  json.setMaxBuffered(16);
+  json.feed(R"({"big": "0123456789012345678901234567890123456789"} {"a":)");
+  EXPECT_EQ(values.size(), 1u);
+  EXPECT_THROW(json.feed(R"( "0123456789012345678901234567890123456789)"),
+               std::length_error);
+  EXPECT_EQ(json.buffered(), 0u);
+  json.feed(R"(0123456789"} {"b": 1})");
+  EXPECT_EQ(json.buffered(), 0u);
+  EXPECT_EQ(values.back(), R"({"b":1})");
+  EXPECT_EQ(values.size(), 2u);
+
+  values.clear();
+  parser::YamlPushParser yaml(collect);
+  yaml.setMaxBuffered(16);
+  yaml.feed("a: 1\n---\nb: ");
+  EXPECT_THROW(yaml.feed(std::string(64, 'x')), std::length_error);
+  EXPECT_LE(yaml.buffered(), 16u);
+  yaml.feed(std::string(64, 'x') + "\nc: 2\n");
+  EXPECT_LE(yaml.buffered(), 16u);
+  yaml.feed("---\nd: 3\n");
+  yaml.finish();
+  EXPECT_EQ(values, std::vector<std::string>({R"({"a":1})", R"({"d":3})"}));
+}
+
+TEST(PushParser, Yaml) {
+  std::string doc =
+      "%YAML 1.2\n"
+      "---\n"
+      "a: 1\n"
+      "b: [x, z]\n"
+      "--- # empty\n"
+      "# comment\n"
+      "---\n"
+      "- 1\n"
+      "- 2\n"
+      "...\n"
+      "---\n"
+      "text: |\n"
+      "  ---\n"
+      "  line\n"
+      "...\n"
+      "c: last";
+  std::vector<std::string> expected = {
+      R"({"a":1,"b":["x","z"]})",
+      "[1,2]",
+      R"({"text":"---\nline\n"})",
+      R"({"c":"last"})",
+  };
+  for (std::size_t step : {1, 5, 4096}) {
+    EXPECT_EQ(feed("yaml", doc, step), expected) << step;
+  }
+
+  EXPECT_TRUE(feed("yaml", "", 1).empty());
+  EXPECT_TRUE(feed("yaml", "---\n...\n# end\n", 1).empty());
+  EXPECT_EQ(parser::PushParser::create("xml", nullptr), nullptr);
+}
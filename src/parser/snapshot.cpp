@@ -0,0 +1,296 @@
+#include "parser/snapshot.h"
+
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "parser/parser.h"
+
+namespace parser {
+
+namespace {
+
+using snapshot::Entry;
+using snapshot::Header;
+using snapshot::Slot;
+
+// 先为容器的全部子节点分配连续的空间，再依次填充，整个快照写入同一缓冲区
+class Writer {
+ public:
+  explicit Writer(std::string& buf) : buf_(buf) {}
+
+  void fill(std::size_t off, const utils::Node& node) {
+    Slot slot{};
+    if (node.isMap()) {
+      slot.type_ = static_cast<uint8_t>(utils::Node::Type::Map);
+      slot.size_ = count(node.size());
+      slot.value_ = alloc(slot.size_ * sizeof(Entry));
+      store(off, slot);
+      // std::map已按键的字节序排列
+      auto entry = slot.value_;
+      for (auto iter = node.begin(); iter != node.end(); ++iter) {
+        string(entry + offsetof(Entry, key_), iter->first);
+        fill(entry + offsetof(Entry, value_), iter->second);
+        entry += sizeof(Entry);
+      }
+      return;
+    }
+
+    if (node.isArray()) {
+      slot.type_ = static_cast<uint8_t>(utils::Node::Type::Array);
+      slot.size_ = count(node.size());
+      slot.value_ = alloc(slot.size_ * sizeof(Slot));
+      store(off, slot);
+      auto item = slot.value_;
+      for (auto iter = node.begin(); iter != node.end(); ++iter) {
+        fill(item, *iter);
+        item += sizeof(Slot);
+      }
+      return;
+    }
+
+    if (node.isString()) {
+      string(off, node.as<std::string>());
+      return;
+    }
+
+    if (node.isBool()) {
+      slot.type_ = static_cast<uint8_t>(utils::Node::Type::Bool);
+      slot.value_ = node.as<bool>();
+    } else if (node.isInteger()) {
+      slot.type_ = static_cast<uint8_t>(utils::Node::Type::Integer);
+      if (node.isUnsigned()) {
+        slot.flags_ = snapshot::kUnsigned;
+        slot.value_ = node.as<uint64_t>();
+      } else {
+        slot.value_ = static_cast<uint64_t>(node.as<int64_t>());
+      }
+    } else if (node.isDouble()) {
+      slot.type_ = static_cast<uint8_t>(utils::Node::Type::Double);
+      auto val = node.as<double>();
+      std::memcpy(&slot.value_, &val, sizeof(val));
+    }
+    store(off, slot);
+  }
+
+ private:
+  static uint32_t count(std::size_t size) {
+    if (size > UINT32_MAX) {
+      throw std::length_error("snapshot: too many elements");
+    }
+    return static_cast<uint32_t>(size);
+  }
+
+  // 在末尾按8字节对齐分配，返回偏移
+  std::size_t alloc(std::size_t size) {
+    auto off = (buf_.size() + 7) & ~static_cast<std::size_t>(7);
+    buf_.resize(off + size);
+    return off;
+  }
+
+  void store(std::size_t off, const Slot& slot) {
+    std::memcpy(buf_.data() + off, &slot, sizeof(slot));
+  }
+
+  void string(std::size_t off, const std::string& str) {
+    Slot slot{};
+    slot.type_ = static_cast<uint8_t>(utils::Node::Type::String);
+    slot.size_ = count(str.size());
+    if (str.size() <= sizeof(slot.value_)) {
+      slot.flags_ = snapshot::kInline;
+      std::memcpy(&slot.value_, str.data(), str.size());
+    } else {
+      slot.value_ = alloc(str.size());
+      std::memcpy(buf_.data() + slot.value_, str.data(), str.size());
+    }
+    store(off, slot);
+  }
+
+  std::string& buf_;
+};
+
+// 逐个节点检查偏移与长度。内容须按Writer的分配顺序排列且互不重叠，
+// 指向已检查区域的偏移被拒绝，不会造成环或重复展开
+class Checker {
+ public:
+  Checker(const char* base, std::size_t size)
+      : base_(base), size_(size), next_(sizeof(Header)) {}
+
+  bool check(const Slot& slot, int depth = 0) {
+    switch (static_cast<utils::Node::Type>(slot.type_)) {
+      case utils::Node::Type::Unset:
+      case utils::Node::Type::Bool:
+      case utils::Node::Type::Integer:
+      case utils::Node::Type::Double:
+        return true;
+      case utils::Node::Type::String:
+        return (slot.flags_ & snapshot::kInline)
+                   ? slot.size_ <= sizeof(slot.value_)
+                   : claim(slot.value_, slot.size_);
+      case utils::Node::Type::Array:
+        return check<Slot>(slot, depth);
+      case utils::Node::Type::Map:
+        return check<Entry>(slot, depth);
+    }
+    return false;
+  }
+
+ private:
+  static constexpr int kMaxDepth = 1024;
+
+  template <typename T>
+  bool check(const Slot& slot, int depth) {
+    if (depth >= kMaxDepth || slot.value_ % 8 != 0 ||
+        !claim(slot.value_, static_cast<uint64_t>(slot.size_) * sizeof(T))) {
+      return false;
+    }
+    auto items = reinterpret_cast<const T*>(base_ + slot.value_);
+    for (uint32_t i = 0; i < slot.size_; ++i) {
+      if constexpr (std::is_same_v<T, Entry>) {
+        if (items[i].key_.type_ !=
+                static_cast<uint8_t>(utils::Node::Type::String) ||
+            !check(items[i].key_, depth + 1) ||
+            !check(items[i].value_, depth + 1)) {
+          return false;
+        }
+      } else if (!check(items[i], depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // [off, off + len)位于文件内且在已检查的内容之后
+  bool claim(uint64_t off, uint64_t len) {
+    if (off < next_ || off > size_ || len > size_ - off) {
+      return false;
+    }
+    next_ = off + len;
+    return true;
+  }
+
+  const char* base_;
+  uint64_t size_;
+  uint64_t next_;
+};
+
+}  // namespace
+
+utils::Node NodeView::toNode(int depth, uint64_t& budget) const {
+  if (budget == 0 || depth >= kMaxDepth) {
+    throw std::invalid_argument("snapshot: nodes reference each other");
+  }
+  --budget;
+  if (isMap()) {
+    auto n = utils::Node::makeMap();
+    for (auto iter = begin(); iter != end(); ++iter) {
+      n[std::string(iter.key())] = (*iter).toNode(depth + 1, budget);
+    }
+    return n;
+  } else if (isArray()) {
+    auto n = utils::Node::makeArray();
+    for (auto iter = begin(); iter != end(); ++iter) {
+      n.push_back((*iter).toNode(depth + 1, budget));
+    }
+    return n;
+  } else if (isBool()) {
+    return utils::Node(as<bool>());
+  } else if (isUnsigned()) {
+    return utils::Node(as<uint64_t>());
+  } else if (isInteger()) {
+    return utils::Node(as<int64_t>());
+  } else if (isDouble()) {
+    return utils::Node(as<double>());
+  } else if (isString()) {
+    return utils::Node(as<std::string>());
+  }
+  return utils::Node();
+}
+
+bool Snapshot::open(const std::string& path) {
+  close();
+  if (!file_.open(path, MappedFile::Access::OnDemand)) {
+    return false;
+  }
+  root_ = view(file_.view());
+  open_ = root_.slot_ != nullptr;
+  if (!open_) {
+    file_.close();
+  }
+  return open_;
+}
+
+void Snapshot::close() {
+  root_ = NodeView();
+  file_.close();
+  open_ = false;
+}
+
+NodeView Snapshot::view(std::string_view bytes) {
+  if (bytes.size() < sizeof(Header) ||
+      reinterpret_cast<uintptr_t>(bytes.data()) % 8 != 0) {
+    return NodeView();
+  }
+  auto header = reinterpret_cast<const Header*>(bytes.data());
+  if (std::memcmp(header->magic_, snapshot::kMagic, sizeof(header->magic_)) !=
+          0 ||
+      header->version_ != snapshot::kVersion || header->size_ != bytes.size()) {
+    return NodeView();
+  }
+  return NodeView(bytes.data(), bytes.size(), &header->root_);
+}
+
+bool Snapshot::write(const std::string& path, const utils::Node& node) {
+  auto bytes = serialize(node);
+  // 写入同目录的临时文件后替换，已映射旧文件的读者不受影响
+  auto tmp = path + ".tmp." + std::to_string(::getpid());
+  std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+  ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  ofs.close();
+  if (!ofs || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string Snapshot::serialize(const utils::Node& node) {
+  std::string buf(sizeof(Header), '\0');
+  Writer(buf).fill(offsetof(Header, root_), node);
+  buf.resize((buf.size() + 7) & ~static_cast<std::size_t>(7));
+
+  Header header{};
+  std::memcpy(header.magic_, snapshot::kMagic, sizeof(header.magic_));
+  header.version_ = snapshot::kVersion;
+  header.size_ = buf.size();
+  // 根节点已由Writer写入
+  std::memcpy(&header.root_, buf.data() + offsetof(Header, root_),
+              sizeof(Slot));
+  std::memcpy(buf.data(), &header, sizeof(header));
+  return buf;
+}
+
+utils::Node Snapshot::deserialize(std::string_view bytes) {
+  // 未按8字节对齐时复制到对齐的缓冲区
+  std::vector<uint64_t> aligned;
+  if (reinterpret_cast<uintptr_t>(bytes.data()) % 8 != 0) {
+    aligned.resize((bytes.size() + 7) / 8);
+    std::memcpy(aligned.data(), bytes.data(), bytes.size());
+    bytes = std::string_view(reinterpret_cast<const char*>(aligned.data()),
+                             bytes.size());
+  }
+  auto root = view(bytes);
+  if (!root.slot_) {
+    throw std::invalid_argument("snapshot: invalid header");
+  }
+  auto header = reinterpret_cast<const Header*>(bytes.data());
+  if (!Checker(bytes.data(), header->size_).check(*root.slot_)) {
+    throw std::invalid_argument("snapshot: corrupted node");
+  }
+  return root.toNode();
+}
+
+REGIST_PARSER(Snapshot)
+
+}  // namespace parser
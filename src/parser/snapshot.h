@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+#include "parser/mapped_file.h"
+#include "parser/parser_impl.h"
+#include "utils/meta.hpp"
+
+/**
+ * @brief
+ * 可直接映射使用的扁平utils::Node快照。
+ * 所有节点以偏移互相引用，按8字节对齐，字典的键按字节序排列以便二分查找。
+ * Snapshot::open只映射文件并检查文件头，耗时与文件大小无关；
+ * NodeView在映射上直接读取，不构造utils::Node，多个进程打开同一文件时共享页缓存。
+ * 数值按本机字节序存储。open不逐项校验文件内容，NodeView在读取容器或字符串的内容前
+ * 检查其偏移与长度是否落在文件内，越界时抛出std::invalid_argument，损坏的文件不会
+ * 导致越界访问；作为解析后端的deserialize则在转换前检查全部节点。
+ * Snapshot::write先写临时文件再替换，不会截断其他进程正在映射的文件。
+ *
+ * e.g.
+ * parser::Snapshot::write("reference.snap", node);
+ *
+ * parser::Snapshot snap("reference.snap");
+ * auto name = snap.root()["modules"][0]["name"].as<std::string_view>();
+ */
+
+namespace parser {
+
+namespace snapshot {
+
+// 一个节点，容器与字符串的内容位于value_指示的偏移处
+struct Slot {
+  uint8_t type_;
+  uint8_t flags_;
+  uint16_t reserved_;
+  // 字符串的长度或容器的元素个数
+  uint32_t size_;
+  // 布尔、整数与浮点的值，不超过8字节的字符串，或内容的偏移
+  uint64_t value_;
+};
+
+// 字典的一项
+struct Entry {
+  Slot key_;
+  Slot value_;
+};
+
+struct Header {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t reserved_;
+  // 文件总长度
+  uint64_t size_;
+  Slot root_;
+};
+
+constexpr char kMagic[8] = {'P', 'H', 'X', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint8_t kUnsigned = 1;
+// 字符串直接存放在value_中
+constexpr uint8_t kInline = 2;
+
+static_assert(sizeof(Slot) == 16 && sizeof(Entry) == 32 &&
+              sizeof(Header) % 8 == 0);
+
+}  // namespace snapshot
+
+class NodeView {
+  using Slot = snapshot::Slot;
+  using Entry = snapshot::Entry;
+  using Type = utils::Node::Type;
+
+ public:
+  class Iterator {
+   public:
+    Iterator() = default;
+
+    NodeView operator*() const {
+      return NodeView(base_, size_, is_map_ ? &entry()->value_ : slot_);
+    }
+    // 字典中当前项的键
+    std::string_view key() const {
+      return NodeView(base_, size_, &entry()->key_).str();
+    }
+    bool operator==(const Iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return slot_ != other.slot_;
+    }
+    Iterator& operator++() {
+      slot_ += is_map_ ? 2 : 1;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto ret = *this;
+      ++*this;
+      return ret;
+    }
+
+   private:
+    Iterator(const char* base, uint64_t size, const Slot* slot, bool is_map)
+        : base_(base), size_(size), slot_(slot), is_map_(is_map) {}
+
+    const Entry* entry() const { return reinterpret_cast<const Entry*>(slot_); }
+
+    const char* base_ = nullptr;
+    uint64_t size_ = 0;
+    const Slot* slot_ = nullptr;
+    bool is_map_ = false;
+
+    friend class NodeView;
+  };
+
+  NodeView() = default;
+  // size为base处映射的总长度，内容的偏移与长度均据此检查
+  NodeView(const char* base, uint64_t size, const Slot* slot)
+      : base_(base), size_(size), slot_(slot) {}
+
+  bool isValid() const { return type() != Type::Unset; }
+  bool isBool() const { return type() == Type::Bool; }
+  bool isInteger() const { return type() == Type::Integer; }
+  bool isUnsigned() const {
+    return isInteger() && (slot_->flags_ & snapshot::kUnsigned);
+  }
+  bool isDouble() const { return type() == Type::Double; }
+  bool isString() const { return type() == Type::String; }
+  bool isArray() const { return type() == Type::Array; }
+  bool isMap() const { return type() == Type::Map; }
+
+  std::size_t size() const {
+    return isArray() || isMap() ? slot_->size_ : 0;
+  }
+
+  template <typename T>
+  T as() const;
+
+  NodeView at(std::string_view key) const {
+    if (!isMap()) {
+      throw std::bad_cast();
+    }
+    if (auto entry = find(key); entry) {
+      return NodeView(base_, size_, &entry->value_);
+    }
+    throw std::out_of_range("NodeView::at: no member " + std::string(key));
+  }
+  NodeView operator[](std::string_view key) const { return at(key); }
+
+  NodeView at(std::size_t idx) const {
+    if (!isArray()) {
+      throw std::bad_cast();
+    }
+    if (idx >= slot_->size_) {
+      throw std::out_of_range("NodeView::at: index out of range");
+    }
+    return NodeView(base_, size_, content<Slot>(slot_->size_) + idx);
+  }
+  NodeView operator[](std::size_t idx) const { return at(idx); }
+
+  bool hasMember(std::string_view key) const {
+    return isMap() && find(key) != nullptr;
+  }
+
+  // 数组遍历元素，字典按键的字节序遍历
+  Iterator begin() const {
+    if (isMap()) {
+      return Iterator(base_, size_, entries(), true);
+    }
+    return Iterator(base_, size_,
+                    isArray() ? content<Slot>(slot_->size_) : nullptr, false);
+  }
+  Iterator end() const {
+    if (isMap()) {
+      return Iterator(base_, size_, entries() + 2 * slot_->size_, true);
+    }
+    return Iterator(
+        base_, size_,
+        isArray() ? content<Slot>(slot_->size_) + slot_->size_ : nullptr,
+        false);
+  }
+
+  // 复制为utils::Node。偏移成环或多处引用同一内容时，嵌套超过kMaxDepth层
+  // 或展开的节点数超过文件所能容纳的数目即抛出std::invalid_argument
+  utils::Node toNode() const {
+    auto budget = size_ / sizeof(Slot);
+    return toNode(0, budget);
+  }
+
+  static constexpr int kMaxDepth = 1024;
+
+ private:
+  Type type() const {
+    return slot_ ? static_cast<Type>(slot_->type_) : Type::Unset;
+  }
+
+  utils::Node toNode(int depth, uint64_t& budget) const;
+
+  // 内容的偏移与长度来自文件，读取前确认count个T位于映射内且对齐
+  template <typename T>
+  const T* content(uint64_t count) const {
+    auto off = slot_->value_;
+    if (off % alignof(T) != 0 || off > size_ ||
+        count * sizeof(T) > size_ - off) {
+      throw std::invalid_argument("snapshot: node out of bounds");
+    }
+    return reinterpret_cast<const T*>(base_ + off);
+  }
+
+  const Slot* entries() const {
+    return reinterpret_cast<const Slot*>(content<Entry>(slot_->size_));
+  }
+
+  std::string_view str() const {
+    if (slot_->flags_ & snapshot::kInline) {
+      if (slot_->size_ > sizeof(slot_->value_)) {
+        throw std::invalid_argument("snapshot: node out of bounds");
+      }
+      return std::string_view(reinterpret_cast<const char*>(&slot_->value_),
+                              slot_->size_);
+    }
+    return std::string_view(content<char>(slot_->size_), slot_->size_);
+  }
+
+  const Entry* find(std::string_view key) const {
+    auto lo = content<Entry>(slot_->size_);
+    auto hi = lo + slot_->size_;
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto cmp = NodeView(base_, size_, &mid->key_).str().compare(key);
+      if (cmp == 0) {
+        return mid;
+      } else if (cmp < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return nullptr;
+  }
+
+  const char* base_ = nullptr;
+  uint64_t size_ = 0;
+  const Slot* slot_ = nullptr;
+
+  friend class Snapshot;
+};
+
+// 与utils::Node::as的转换规则一致，另支持零拷贝的std::string_view
+template <typename T>
+T NodeView::as() const {
+  auto value = slot_ ? slot_->value_ : 0;
+  switch (type()) {
+    case Type::Bool:
+      if constexpr (std::is_same_v<T, std::string>) {
+        return std::to_string(value != 0);
+      } else if constexpr (std::is_arithmetic_v<T>) {
+        return static_cast<T>(value != 0);
+      }
+      break;
+
+    case Type::Integer:
+      if constexpr (std::is_same_v<T, std::string>) {
+        return isUnsigned() ? std::to_string(value)
+                            : std::to_string(static_cast<int64_t>(value));
+      } else if constexpr (std::is_arithmetic_v<T>) {
+        return isUnsigned() ? static_cast<T>(value)
+                            : static_cast<T>(static_cast<int64_t>(value));
+      }
+      break;
+
+    case Type::Double: {
+      double val;
+      std::memcpy(&val, &value, sizeof(val));
+      if constexpr (std::is_same_v<T, std::string>) {
+        return std::to_string(val);
+      } else if constexpr (std::is_arithmetic_v<T>) {
+        return static_cast<T>(val);
+      }
+    } break;
+
+    case Type::String:
+      if constexpr (std::is_same_v<T, std::string_view>) {
+        return str();
+      } else if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(str());
+      } else if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(std::stod(std::string(str())));
+      } else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+        return static_cast<T>(std::stoll(std::string(str())));
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  throw std::invalid_argument(
+      "Cannot convert Type " + std::to_string(static_cast<int>(type())) +
+      " to " + type_traits::demangle(typeid(T).name()));
+}
+
+class Snapshot : public noncopyable {
+ public:
+  Snapshot() = default;
+  explicit Snapshot(const std::string& path) { open(path); }
+
+  // 映射文件并检查文件头，不读取节点
+  bool open(const std::string& path);
+  void close();
+  bool isOpen() const { return open_; }
+
+  NodeView root() const { return root_; }
+
+  // 检查文件头，通过时返回根节点，否则返回无效的NodeView
+  static NodeView view(std::string_view bytes);
+
+  static bool write(const std::string& path, const utils::Node& node);
+
+  /**
+   * @brief
+   * 作为解析后端时整体转换为utils::Node，供Parser::read等接口使用。
+   * 节点的偏移或长度越界时抛出std::invalid_argument
+   */
+  constexpr static char key[] = "snap";
+  static std::string serialize(const utils::Node& node);
+  static utils::Node deserialize(std::string_view bytes);
+
+ private:
+  MappedFile file_;
+  NodeView root_;
+  bool open_ = false;
+};
+
+}  // namespace parser
@@ -0,0 +1,83 @@
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "parser/parser.h"
+#include "parser/snapshot.h"
+
+// 快照打开测试：./parser.snapshot_test [记录数，默认500000]
+// 同一份数据分别存为json、msgpack与快照，
+// 统计从打开文件到取得最后一条记录某个字段的耗时与堆占用
+
+static utils::Node records(int count) {
+  utils::Node n;
+  for (int i = 0; i < count; ++i) {
+    utils::Node r;
+    r["id"] = static_cast<int64_t>(i) * 1000003;
+    r["name"] = "user_" + std::to_string(i);
+    r["score"] = i * 0.25;
+    r["tags"].push_back("a");
+    r["tags"].push_back("b");
+    n["records"].push_back(r);
+  }
+  n["version"] = 3;
+  return n;
+}
+
+static std::size_t heap() {
+  auto info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+template <typename F>
+static void measure(const std::string& name, const std::string& path, F&& f) {
+  auto base = heap();
+  auto start = std::chrono::steady_clock::now();
+  auto name_len = f(path);
+  auto cost = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+  std::cout << name << ": file " << (ifs.tellg() >> 20) << " MB, open+lookup "
+            << cost << " ms, heap " << ((heap() - base) >> 20) << " MB"
+            << (name_len == 0 ? " (lookup failed)" : "") << std::endl;
+}
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::stoi(argv[1]) : 500000;
+  auto node = records(count);
+  auto last = count - 1;
+
+  std::string prefix = "/tmp/parser_snapshot_test.";
+  for (auto format : {"json", "msgpack"}) {
+    std::ofstream ofs(prefix + format, std::ios::binary | std::ios::trunc);
+    ofs << parser::Parser::serialize(format, node);
+  }
+  parser::Snapshot::write(prefix + "snap", node);
+  node = utils::Node();
+
+  // 解析得到的树保留到测量结束，计入堆占用
+  utils::Node keep;
+  for (auto format : {"json", "msgpack"}) {
+    measure(format, prefix + format, [&keep, last](const std::string& path) {
+      keep = parser::Parser::read(path);
+      return keep["records"][last]["name"].as<std::string>().size();
+    });
+    keep = utils::Node();
+  }
+
+  parser::Snapshot snap;
+  measure("snap", prefix + "snap", [&snap, last](const std::string& path) {
+    snap.open(path);
+    return snap.root()["records"][last]["name"].as<std::string_view>().size();
+  });
+
+  for (auto format : {"json", "msgpack", "snap"}) {
+    std::remove((prefix + format).c_str());
+  }
+  return 0;
+}
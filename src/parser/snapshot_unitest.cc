@@ -0,0 +1,163 @@
+#include "parser/snapshot.h"
+#include "parser/parser.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+static utils::Node sample() {
+  utils::Node n;
+  n["bool"] = true;
+  n["int"] = INT64_MIN;
+  n["uint"] = UINT64_MAX;
+  n["double"] = 0.5;
+  n["string"] = "phoenix";
+  n["long_string"] = std::string(100, 'x');
+  n["empty_map"] = utils::Node::makeMap();
+  n["empty_array"] = utils::Node::makeArray();
+  n["null"] = utils::Node();
+  for (int i = 0; i < 100; ++i) {
+    utils::Node item;
+    item["id"] = i;
+    item["name"] = "item_" + std::to_string(i);
+    n["items"].push_back(item);
+  }
+  return n;
+}
+
+TEST(Snapshot, View) {
+  auto path = testing::TempDir() + "snapshot_view.snap";
+  ASSERT_TRUE(parser::Snapshot::write(path, sample()));
+
+  parser::Snapshot snap(path);
+  ASSERT_TRUE(snap.isOpen());
+  auto root = snap.root();
+  EXPECT_TRUE(root.isMap());
+  EXPECT_EQ(root.size(), 10u);
+  EXPECT_EQ(root["bool"].as<bool>(), true);
+  EXPECT_EQ(root["int"].as<int64_t>(), INT64_MIN);
+  EXPECT_TRUE(root["uint"].isUnsigned());
+  EXPECT_EQ(root["uint"].as<uint64_t>(), UINT64_MAX);
+  EXPECT_EQ(root["double"].as<double>(), 0.5);
+  EXPECT_EQ(root["string"].as<std::string_view>(), "phoenix");
+  EXPECT_EQ(root["string"].as<std::string>(), "phoenix");
+  EXPECT_EQ(root["long_string"].as<std::string_view>(), std::string(100, 'x'));
+  EXPECT_TRUE(root["empty_map"].isMap());
+  EXPECT_EQ(root["empty_array"].size(), 0u);
+  EXPECT_FALSE(root["null"].isValid());
+  EXPECT_FALSE(root.hasMember("missing"));
+  EXPECT_THROW(root.at("missing"), std::out_of_range);
+  EXPECT_THROW(root["items"].at(100), std::out_of_range);
+  EXPECT_THROW(root["string"].at(0), std::bad_cast);
+
+  auto items = root["items"];
+  ASSERT_EQ(items.size(), 100u);
+  EXPECT_EQ(items[42]["name"].as<std::string_view>(), "item_42");
+  int idx = 0;
+  for (auto iter = items.begin(); iter != items.end(); ++iter, ++idx) {
+    EXPECT_EQ((*iter)["id"].as<int>(), idx);
+  }
+  EXPECT_EQ(idx, 100);
+
+  // 字典按键的字节序遍历
+  std::string last;
+  for (auto iter = root.begin(); iter != root.end(); ++iter) {
+    EXPECT_LT(last, iter.key());
+    last = iter.key();
+  }
+  unlink(path.c_str());
+}
+
+TEST(Snapshot, Invalid) {
+  auto path = testing::TempDir() + "snapshot_invalid.snap";
+  {
+    std::ofstream ofs(path);
+    ofs << "{\"not\": \"a snapshot\", \"padding\": \"0123456789abcdef\"}";
+  }
+  parser::Snapshot snap;
+  EXPECT_FALSE(snap.open(path));
+  EXPECT_FALSE(snap.isOpen());
+  EXPECT_FALSE(snap.open("/nonexistent/snapshot.snap"));
+  unlink(path.c_str());
+
+  // 截断后文件长度与文件头不符
+  auto bytes = parser::Snapshot::serialize(sample());
+  bytes.resize(bytes.size() - 8);
+  EXPECT_ANY_THROW(parser::Parser::deserialize("snap", bytes));
+
+  // 根节点的内容越界或指回文件头
+  bytes = parser::Snapshot::serialize(sample());
+  auto header = reinterpret_cast<parser::snapshot::Header*>(bytes.data());
+  header->root_.value_ = bytes.size();
+  EXPECT_THROW(parser::Parser::deserialize("snap", bytes),
+               std::invalid_argument);
+  header->root_.value_ = 0;
+  EXPECT_THROW(parser::Parser::deserialize("snap", bytes),
+               std::invalid_argument);
+
+  // 逐个改写节点区域的每个字，要么抛出要么得到结果，不越界访问
+  auto origin = parser::Snapshot::serialize(sample());
+  for (std::size_t off = sizeof(parser::snapshot::Header); off < origin.size();
+       off += 8) {
+    for (uint64_t value : {uint64_t(0), uint64_t(8), ~uint64_t(0) >> 1}) {
+      bytes = origin;
+      std::memcpy(bytes.data() + off, &value, sizeof(value));
+      try {
+        parser::Parser::deserialize("snap", bytes);
+      } catch (const std::exception&) {
+      }
+      // 不经检查直接读取映射时同样只会抛出
+      auto root = parser::Snapshot::view(bytes);
+      ASSERT_TRUE(root.isMap());
+      try {
+        root.toNode();
+        root["items"][42]["name"].as<std::string_view>();
+      } catch (const std::exception&) {
+      }
+    }
+  }
+
+  // 数组的内容指回自身所在的位置，逐层展开时在限定深度内停止
+  bytes = parser::Snapshot::serialize(utils::Node::makeArray());
+  header = reinterpret_cast<parser::snapshot::Header*>(bytes.data());
+  header->root_.size_ = 1;
+  header->root_.value_ = offsetof(parser::snapshot::Header, root_);
+  auto root = parser::Snapshot::view(bytes);
+  EXPECT_EQ(root[0][0][0].size(), 1u);
+  EXPECT_THROW(root.toNode(), std::invalid_argument);
+}
+
+TEST(Snapshot, Replace) {
+  auto path = testing::TempDir() + "snapshot_replace.snap";
+  ASSERT_TRUE(parser::Snapshot::write(path, sample()));
+  parser::Snapshot snap(path);
+  ASSERT_TRUE(snap.isOpen());
+
+  // 替换文件不影响已映射的旧版本
+  utils::Node other;
+  other["string"] = "replaced";
+  ASSERT_TRUE(parser::Snapshot::write(path, other));
+  EXPECT_EQ(snap.root()["string"].as<std::string_view>(), "phoenix");
+  EXPECT_EQ(snap.root()["items"].size(), 100u);
+
+  parser::Snapshot next(path);
+  EXPECT_EQ(next.root()["string"].as<std::string_view>(), "replaced");
+  EXPECT_FALSE(parser::Snapshot::write("/nonexistent/snapshot.snap", other));
+  unlink(path.c_str());
+}
+
+TEST(Snapshot, Parser) {
+  auto bytes = parser::Parser::serialize("snap", sample());
+  auto n = parser::Parser::deserialize("snap", bytes);
+  EXPECT_EQ(n["uint"].as<uint64_t>(), UINT64_MAX);
+  EXPECT_EQ(n["items"][7]["name"].as<std::string>(), "item_7");
+  EXPECT_TRUE(n["empty_map"].isMap());
+
+  // 未对齐的输入
+  std::string shifted = " " + bytes;
+  auto m = parser::Parser::deserialize(
+      "snap", std::string_view(shifted).substr(1));
+  EXPECT_EQ(m["string"].as<std::string>(), "phoenix");
+}
@@ -1,6 +1,10 @@
 #include "parser/yaml.h"
 
 #include <yaml-cpp/yaml.h>
+
+#include <istream>
+#include <streambuf>
+
 #include "parser/parser.h"
 
 namespace parser {
@@ -50,8 +54,23 @@ static utils::Node deserialize(YAML::Node yml) {
   return n;
 }
 
-utils::Node Yaml::deserialize(const std::string& bytes) {
-  return ::parser::deserialize(YAML::Load(bytes));
+namespace {
+
+// 只读地引用外部缓冲区的流，避免YAML::Load(std::string)复制输入
+class ViewBuf : public std::streambuf {
+ public:
+  explicit ViewBuf(std::string_view bytes) {
+    auto p = const_cast<char*>(bytes.data());
+    setg(p, p, p + bytes.size());
+  }
+};
+
+}  // namespace
+
+utils::Node Yaml::deserialize(std::string_view bytes) {
+  ViewBuf buf(bytes);
+  std::istream is(&buf);
+  return ::parser::deserialize(YAML::Load(is));
 }
 
 static YAML::Node serialize(const utils::Node& node) {
@@ -12,7 +12,7 @@ class Yaml {
   constexpr static char key[] = "yaml";
 
   static std::string serialize(const utils::Node&);
-  static utils::Node deserialize(const std::string&);
+  static utils::Node deserialize(std::string_view);
 };
 
 }  // namespace parser
\ No newline at end of file
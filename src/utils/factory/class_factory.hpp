@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <utility>
 
+#include "utils/factory/lazy_register.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/nonmovable.hpp"
 #include "utils/single_ton.hpp"
@@ -24,14 +25,21 @@ class ClassFactory : public noncopyable, public nonmovable {
     return creators_.insert(std::make_pair(k, creator)).second;
   }
 
-  bool Contains(Key k) { return creators_.count(k) == 1; }
+  bool Contains(Key k) {
+    materialize<ClassFactory>();
+    return creators_.count(k) == 1;
+  }
 
   void Clear() { creators_.clear(); }
 
-  bool Empty() { return creators_.empty(); }
+  bool Empty() {
+    materialize<ClassFactory>();
+    return creators_.empty();
+  }
 
   template <typename... Args>
   Ptr<Prod> Create(Key k, Args&&... args) {
+    materialize<ClassFactory>();
     typename std::unordered_map<Key, ProdCreator>::const_iterator cit =
         creators_.find(k);
     if (cit == creators_.end())
@@ -40,6 +48,7 @@ class ClassFactory : public noncopyable, public nonmovable {
   }
 
   std::vector<Key> keys() const {
+    materialize<ClassFactory>();
     std::vector<Key> ret;
     ret.reserve(creators_.size());
     for (auto const& [key, value] : creators_) {
@@ -61,6 +61,8 @@ class ClassRegister {
 template <class Factory, class Derived>
 class Register {
  public:
+  using RegistryT = typename Factory::InstT;
+
   Register() {
     Factory::instance().RegisterCreator(Derived::type, Derived::create);
   }
@@ -70,6 +72,7 @@ template <class Factory, class Derived, typename... Args>
 class RegisterWithArgs {
  public:
   using FactoryT = typename Factory::InstT;
+  using RegistryT = FactoryT;
   using BaseT = typename FactoryT::BaseT;
 
   using BasePtr = typename FactoryT::template PtrT<BaseT>;
@@ -0,0 +1,170 @@
+/**
+ * @brief
+ * 基于链接器段的延迟注册。
+ * 每个注册项是常量初始化的{所属注册表, 安装函数}，由链接器收集到同一个段中，
+ * 启动时每个模块(可执行文件或动态库)只登记一次本模块的段，开销与注册项的个数无关；
+ * 注册表首次被查询时才遍历已登记的段，调用属于它的安装函数填充查找表。
+ *
+ * 段由链接器按模块分别生成。注册表已被查询之后才加载的动态库(插件)在加载时
+ * 立即安装其中属于该注册表的注册项；卸载时注销其段，已安装的项不会撤销。
+ * 跨模块时依靠默认可见性的符号合并LazyRegistry与RegistryTag，
+ * 插件须链接定义注册表的动态库。
+ *
+ * e.g.
+ * // derivedA.cc
+ * LAZY_CLASS_REGISTER(Register<BaseFactory, DerivedA>)
+ *
+ * static void install() { Registry::instance().add(...); }
+ * LAZY_REGISTER(Registry, install)
+ */
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "utils/macros.hpp"
+
+// 段中的各项须紧密排列，不能超过16字节，否则编译器会加大对齐而留下空隙
+struct RegistryEntry {
+  // 所属注册表的标识，即RegistryTag<Registry>::value的地址
+  const void* registry;
+  void (*install)();
+};
+static_assert(sizeof(RegistryEntry) == 16);
+
+template <class Registry>
+struct RegistryTag {
+  static constexpr char value = 0;
+};
+
+// 段名须为合法的C标识符，链接器才会生成__start_/__stop_符号
+#define LAZY_REGISTRY_SECTION "phoenix_registry"
+
+// 每个模块只能看到自己的段，声明为hidden；没有注册项时为空
+extern "C" {
+extern const RegistryEntry __start_phoenix_registry[]
+    __attribute__((weak, visibility("hidden")));
+extern const RegistryEntry __stop_phoenix_registry[]
+    __attribute__((weak, visibility("hidden")));
+}
+
+// 进程内所有已加载模块的段，以及已经查询过的注册表
+class LazyRegistry {
+ public:
+  static LazyRegistry& instance() {
+    static LazyRegistry inst;
+    return inst;
+  }
+
+  // 重复登记同一个段时忽略
+  void addSection(const RegistryEntry* begin, const RegistryEntry* end) {
+    std::scoped_lock lck(mtx_);
+    if (begin == end ||
+        std::any_of(sections_.begin(), sections_.end(),
+                    [begin](const auto& s) { return s.first == begin; })) {
+      return;
+    }
+    sections_.emplace_back(begin, end);
+    for (auto registry : materialized_) {
+      install(begin, end, registry);
+    }
+  }
+
+  void removeSection(const RegistryEntry* begin) {
+    std::scoped_lock lck(mtx_);
+    sections_.erase(
+        std::remove_if(sections_.begin(), sections_.end(),
+                       [begin](const auto& s) { return s.first == begin; }),
+        sections_.end());
+  }
+
+  void materialize(const void* registry) {
+    std::scoped_lock lck(mtx_);
+    if (std::find(materialized_.begin(), materialized_.end(), registry) !=
+        materialized_.end()) {
+      return;
+    }
+    materialized_.push_back(registry);
+    for (auto [begin, end] : sections_) {
+      install(begin, end, registry);
+    }
+  }
+
+ private:
+  LazyRegistry() = default;
+
+  static void install(const RegistryEntry* begin,
+                      const RegistryEntry* end,
+                      const void* registry) {
+    for (auto entry = begin; entry != end; ++entry) {
+      if (entry->registry == registry) {
+        entry->install();
+      }
+    }
+  }
+
+  // 安装函数可能查询其他注册表
+  std::recursive_mutex mtx_;
+  std::vector<std::pair<const RegistryEntry*, const RegistryEntry*>> sections_;
+  std::vector<const void*> materialized_;
+};
+
+// 本模块的段，加载时登记、卸载时注销；hidden使各模块的构造函数引用各自的段
+struct __attribute__((visibility("hidden"))) LazySection {
+  LazySection() {
+    LazyRegistry::instance().addSection(__start_phoenix_registry,
+                                        __stop_phoenix_registry);
+  }
+  ~LazySection() {
+    LazyRegistry::instance().removeSection(__start_phoenix_registry);
+  }
+};
+
+// 每个注册项都引用它，使含注册项的模块恰有一个实例并在加载时登记本模块的段
+inline __attribute__((visibility("hidden"))) LazySection lazy_section;
+
+/**
+ * @brief
+ * 在注册表的每个查询入口调用，首次调用时安装所有已加载模块中属于Registry的注册项。
+ * 安装函数中不能查询同一个注册表
+ */
+template <class Registry>
+__attribute__((visibility("hidden"))) void materialize() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    auto& inst = LazyRegistry::instance();
+    // 静态初始化期间查询时本模块的lazy_section可能尚未构造
+    inst.addSection(__start_phoenix_registry, __stop_phoenix_registry);
+    inst.materialize(&RegistryTag<Registry>::value);
+  });
+}
+
+// 注册install到Registry，须在命名空间作用域中使用
+#define LAZY_REGISTER(Registry, install)                                 \
+  __attribute__((used, section(LAZY_REGISTRY_SECTION))) static const     \
+      RegistryEntry CONCAT(s_lazy_reg_, __COUNTER__) = {                 \
+          &RegistryTag<Registry>::value, install};                       \
+  __attribute__((used)) static const LazySection* const CONCAT(         \
+      s_lazy_sec_, __COUNTER__) = &lazy_section;
+
+template <class Register>
+void lazy_install() {
+  Register reg;
+}
+
+/**
+ * @brief
+ * ClassRegister的延迟版本，参数为Register/RegisterWithArgs等注册策略，
+ * 须声明RegistryT为其注册的注册表类型。
+ * GCC忽略模板实例上的section属性，因此以宏在派生类的源文件中注册，
+ * 放在头文件中会在每个包含它的源文件中各注册一次
+ */
+#define LAZY_CLASS_REGISTER(...)                                       \
+  __attribute__((used, section(LAZY_REGISTRY_SECTION))) static const   \
+      RegistryEntry CONCAT(s_lazy_reg_, __COUNTER__) = {                \
+          &RegistryTag<__VA_ARGS__::RegistryT>::value,                  \
+          &lazy_install<__VA_ARGS__>};                                  \
+  __attribute__((used)) static const LazySection* const CONCAT(       \
+      s_lazy_sec_, __COUNTER__) = &lazy_section;
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "utils/factory/class_factory.hpp"
+#include "utils/factory/class_register.hpp"
+#include "utils/factory/lazy_register.hpp"
+
+namespace {
+
+int installed = 0;
+
+struct Shape {
+  virtual ~Shape() = default;
+  virtual int sides() const = 0;
+};
+
+using ShapeFactory = FactorySingleTon<std::string, Shape>;
+
+template <class Factory, class Derived>
+class CountedRegister : public Register<Factory, Derived> {
+ public:
+  CountedRegister() { ++installed; }
+};
+
+struct Triangle : public Shape {
+  constexpr static char type[] = "triangle";
+  static std::shared_ptr<Shape> create() {
+    return std::make_shared<Triangle>();
+  }
+  int sides() const override { return 3; }
+};
+
+struct Square : public Shape {
+  constexpr static char type[] = "square";
+  static std::shared_ptr<Shape> create() { return std::make_shared<Square>(); }
+  int sides() const override { return 4; }
+};
+
+// 自定义的注册表
+class NameTable : public noncopyable, public nonmovable {
+ public:
+  std::vector<std::string> names_;
+};
+using NameTableInst = SingleTon<NameTable>;
+
+void installA() {
+  NameTableInst::instance().names_.push_back("a");
+}
+void installB() {
+  NameTableInst::instance().names_.push_back("b");
+}
+
+}  // namespace
+
+LAZY_CLASS_REGISTER(CountedRegister<ShapeFactory, Triangle>)
+LAZY_CLASS_REGISTER(CountedRegister<ShapeFactory, Square>)
+LAZY_REGISTER(NameTable, installA)
+LAZY_REGISTER(NameTable, installB)
+
+TEST(LazyRegister, Factory) {
+  // main之前没有任何注册
+  EXPECT_EQ(installed, 0);
+
+  auto triangle = ShapeFactory::instance().Create("triangle");
+  ASSERT_NE(triangle, nullptr);
+  EXPECT_EQ(triangle->sides(), 3);
+  EXPECT_EQ(installed, 2);
+  EXPECT_EQ(ShapeFactory::instance().Create("square")->sides(), 4);
+  EXPECT_EQ(ShapeFactory::instance().Create("circle"), nullptr);
+  EXPECT_EQ(ShapeFactory::instance().keys().size(), 2u);
+  // 只安装一次
+  EXPECT_EQ(installed, 2);
+}
+
+TEST(LazyRegister, Macro) {
+  EXPECT_TRUE(NameTableInst::instance().names_.empty());
+  materialize<NameTable>();
+  materialize<NameTable>();
+  ASSERT_EQ(NameTableInst::instance().names_.size(), 2u);
+}
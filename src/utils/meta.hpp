@@ -18,6 +18,7 @@
 #include <limits>
 #include <memory>
 #include <ostream>
+#include <string_view>
 #include <vector>
 #include "utils/assert.h"
 #include "utils/string.h"
@@ -45,7 +46,13 @@ struct MetaImpl<T, std::enable_if_t<is_numeric_v<T>>> : public Meta {
   T val_;
 };
 
-using IntegerMeta = MetaImpl<int64_t>;
+struct IntegerMeta : public Meta {
+  IntegerMeta(int64_t val) : val_(val) {}
+
+  int64_t val_;
+  // 超出int64_t范围的uint64_t，val_保存其位模式
+  bool unsigned_ = false;
+};
 using FPointMeta = MetaImpl<double>;
 
 struct StringMeta : public Meta {
@@ -125,6 +132,10 @@ class Node {
   template <std::size_t N>
   Node(const char (&val)[N]);
 
+  // 空的数组与字典
+  static Node makeArray();
+  static Node makeMap();
+
   void merge(utils::Node& other, const std::string& tar = "/");
 
   bool isValid() const;
@@ -133,6 +144,8 @@ class Node {
 
   bool isBool() const;
   bool isInteger() const;
+  // 超出int64_t范围的无符号整数，须以uint64_t读取
+  bool isUnsigned() const;
   bool isDouble() const;
   bool isString() const;
   bool isArray() const;
@@ -150,6 +163,8 @@ class Node {
                                                            std::string>,
                              bool> = true>
   T as() const;
+  // 字符串节点的内容，不复制，节点修改或析构前有效，其他类型抛出
+  std::string_view view() const;
 
   Iterator begin() const;
   Iterator end() const;
@@ -358,6 +373,26 @@ inline bool Node::isInteger() const {
   return child_->type_ == Node::Type::Integer;
 }
 
+inline bool Node::isUnsigned() const {
+  return isInteger() &&
+         std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_)
+             ->unsigned_;
+}
+
+inline Node Node::makeArray() {
+  Node n;
+  n.child_->node_ = std::make_shared<ArrayNode>();
+  n.child_->type_ = Type::Array;
+  return n;
+}
+
+inline Node Node::makeMap() {
+  Node n;
+  n.child_->node_ = std::make_shared<MapNode>();
+  n.child_->type_ = Type::Map;
+  return n;
+}
+
 inline bool Node::isDouble() const {
   return child_->type_ == Node::Type::Double;
 }
@@ -366,6 +401,16 @@ inline bool Node::isString() const {
   return child_->type_ == Node::Type::String;
 }
 
+inline std::string_view Node::view() const {
+  if (child_->type_ != Node::Type::String) {
+    throw std::invalid_argument(
+        "Cannot view Type " + std::to_string(static_cast<int>(child_->type_)) +
+        " as string");
+  }
+  auto value = static_cast<const ValueNode*>(child_->node_.get());
+  return static_cast<const StringMeta*>(value->meta_.get())->val_;
+}
+
 inline bool Node::isArray() const {
   return child_->type_ == Node::Type::Array;
 }
@@ -488,16 +533,19 @@ inline std::vector<Node>::iterator Node::arrayEnd() const {
 }
 
 template <typename T,
-          std::enable_if_t<is_numeric_v<T> || is_bool_v<T>, bool> = true>
+          std::enable_if_t<is_numeric_v<T> || is_bool_v<T>, bool>>
 T Node::as() const {
   switch (child_->type_) {
     case Node::Type::Bool:
       return std::static_pointer_cast<BoolMeta>(child<ValueNode>()->meta_)
           ->val_;
 
-    case Node::Type::Integer:
-      return std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_)
-          ->val_;
+    case Node::Type::Integer: {
+      auto meta =
+          std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_);
+      return meta->unsigned_ ? static_cast<T>(static_cast<uint64_t>(meta->val_))
+                             : static_cast<T>(meta->val_);
+    }
 
     case Node::Type::Double:
       return std::static_pointer_cast<FPointMeta>(child<ValueNode>()->meta_)
@@ -534,17 +582,20 @@ T Node::as() const {
                               " to " + type_traits::demangle(typeid(T).name()));
 }
 
-template <typename T, std::enable_if_t<is_string_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_string_v<T>, bool>>
 T Node::as() const {
   switch (child_->type_) {
     case Node::Type::Bool:
       return std::to_string(
           std::static_pointer_cast<BoolMeta>(child<ValueNode>()->meta_)->val_);
 
-    case Node::Type::Integer:
-      return std::to_string(
-          std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_)
-              ->val_);
+    case Node::Type::Integer: {
+      auto meta =
+          std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_);
+      return meta->unsigned_
+                 ? std::to_string(static_cast<uint64_t>(meta->val_))
+                 : std::to_string(meta->val_);
+    }
 
     case Node::Type::Double:
       return std::to_string(
@@ -564,7 +615,7 @@ T Node::as() const {
                               " to " + type_traits::demangle(typeid(T).name()));
 }
 
-template <typename T, std::enable_if_t<is_vector_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_vector_v<T>, bool>>
 T Node::as() const {
   T ret;
   if (LIKELY(child_->type_ == Node::Type::Array)) {
@@ -583,7 +634,7 @@ T Node::as() const {
 template <typename T,
           std::enable_if_t<
               is_map_v<T> && std::is_same_v<typename T::key_type, std::string>,
-              bool> = true>
+              bool>>
 T Node::as() const {
   T ret;
   if (LIKELY(child_->type_ == Node::Type::Map)) {
@@ -599,7 +650,7 @@ T Node::as() const {
   return ret;
 }
 
-template <typename T, std::enable_if_t<is_bool_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_bool_v<T>, bool>>
 Node& Node::operator=(const T val) {
   if (child_->type_ != Type::Bool) {
     auto p = std::make_shared<ValueNode>();
@@ -611,7 +662,7 @@ Node& Node::operator=(const T val) {
   return *this;
 }
 
-template <typename T, std::enable_if_t<is_integer_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_integer_v<T>, bool>>
 Node& Node::operator=(const T val) {
   if (child_->type_ != Type::Integer) {
     auto p = std::make_shared<ValueNode>();
@@ -619,12 +670,20 @@ Node& Node::operator=(const T val) {
     child_->node_ = Node::Cast<Node>(p);
     child_->type_ = Type::Integer;
   }
-  std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_)->val_ = val;
+  auto meta = std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_);
+  meta->val_ = static_cast<int64_t>(val);
+  if constexpr (std::is_unsigned_v<T>) {
+    meta->unsigned_ =
+        static_cast<uint64_t>(val) >
+        static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  } else {
+    meta->unsigned_ = false;
+  }
   return *this;
 }
 
 template <typename T,
-          std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+          std::enable_if_t<std::is_floating_point_v<T>, bool>>
 Node& Node::operator=(const T val) {
   if (child_->type_ != Type::Double) {
     auto p = std::make_shared<ValueNode>();
@@ -636,7 +695,7 @@ Node& Node::operator=(const T val) {
   return *this;
 }
 
-template <typename T, std::enable_if_t<is_string_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_string_v<T>, bool>>
 Node& Node::operator=(const T& val) {
   if (child_->type_ != Type::String) {
     auto p = std::make_shared<ValueNode>();
@@ -666,7 +725,7 @@ inline std::string Node::tag() const {
 
 template <typename T,
           std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>,
-                           bool> = true>
+                           bool>>
 void Node::push_back(const T val) {
   if (child_->type_ != Type::Array) {
     auto p = std::make_shared<ArrayNode>();
@@ -677,7 +736,7 @@ void Node::push_back(const T val) {
   child<ArrayNode>()->nodes_.emplace_back(n);
 }
 
-template <typename T, std::enable_if_t<is_string_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_string_v<T>, bool>>
 void Node::push_back(const T& val) {
   if (child_->type_ != Type::Array) {
     auto p = std::make_shared<ArrayNode>();
@@ -711,7 +770,7 @@ inline void Node::push_back(const Node& n) {
 
 template <typename T,
           std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>,
-                           bool> = true>
+                           bool>>
 Node Node::insert(const std::string& key, const T val) {
   if (child_->type_ != Type::Map) {
     auto p = std::make_shared<MapNode>();
@@ -728,7 +787,7 @@ Node Node::insert(const std::string& key, const T val) {
   return ret;
 }
 
-template <typename T, std::enable_if_t<is_string_v<T>, bool> = true>
+template <typename T, std::enable_if_t<is_string_v<T>, bool>>
 Node Node::insert(const std::string& key, const T& val) {
   if (child_->type_ != Type::Map) {
     auto p = std::make_shared<MapNode>();
@@ -830,7 +889,9 @@ inline Node Node::clone() const {
       auto src =
           std::static_pointer_cast<IntegerMeta>(child<ValueNode>()->meta_);
       auto tar = std::make_shared<ValueNode>();
-      tar->meta_ = std::make_shared<IntegerMeta>(src->val_);
+      auto meta = std::make_shared<IntegerMeta>(src->val_);
+      meta->unsigned_ = src->unsigned_;
+      tar->meta_ = meta;
       n.child_->node_ = Node::Cast<Node>(tar);
     } break;
     case Node::Type::Double: {
@@ -874,6 +935,8 @@ inline Node Node::clone() const {
 inline std::ostream& operator<<(std::ostream& oss, Node& n) {
   if (n.isBool()) {
     oss << n.as<bool>();
+  } else if (n.isUnsigned()) {
+    oss << n.as<uint64_t>();
   } else if (n.isInteger()) {
     oss << n.as<int64_t>();
   } else if (n.isDouble()) {
@@ -257,4 +257,9 @@ TEST(Meta, As) {
   EXPECT_EQ(n.as<int>(), 73);
   EXPECT_EQ(n.as<bool>(), true);
   EXPECT_EQ(n.as<double>(), static_cast<double>(73));
+
+  // view不复制字符串
+  EXPECT_EQ(n.view(), "73");
+  EXPECT_EQ(n.view().data(), n.view().data());
+  EXPECT_THROW(Node(1).view(), std::invalid_argument);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <list>
+#include <mutex>
 #include <shared_mutex>
 
 namespace utils::thread {
@@ -12,9 +13,17 @@ class list {
   using iterator = typename std::list<T>::iterator;
   list() = default;
 
-  void push_back(const T& v) {
+  // 返回插入前是否为空，便于生产者只在首个元素入队时唤醒消费者
+  bool push_back(const T& v) {
     std::unique_lock lck(mtx_list_);
+    bool empty = list_.empty();
     list_.push_back(v);
+    return empty;
+  }
+
+  void push_back(std::list<T>&& vs) {
+    std::unique_lock lck(mtx_list_);
+    list_.splice(list_.end(), vs);
   }
 
   bool erase(const T& v) {
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/thread/annotations.hpp"
+#include "utils/thread/wait.hpp"
+
+namespace utils::thread {
+
+/**
+ * @brief
+ * 固定大小的线程池，任务按投递顺序取出执行。
+ * 析构时执行完已投递的任务后退出
+ */
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+      workers_.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::scoped_lock lck(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) {
+      w.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void post(Task task) {
+    {
+      std::scoped_lock lck(mtx_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+  std::size_t size() const { return workers_.size(); }
+
+ private:
+  void work() {
+    for (;;) {
+      Task task;
+      {
+        std::unique_lock lck(mtx_);
+        auto ready = [this]() { return stop_ || !tasks_.empty(); };
+        wait(cv_, lck, ready);
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<Task> tasks_ GAURDED_BY(mtx_);
+  bool stop_ GAURDED_BY(mtx_) = false;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace utils::thread
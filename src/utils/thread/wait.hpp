@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace utils::thread {
+
+/**
+ * @brief
+ * 不设超时地等待pred成立，与cv.wait(lck, pred)等价。
+ * GCC 12起condition_variable::wait(unique_lock&)导出为GLIBCXX_3.4.30的符号，
+ * 以截止时间为无穷远的wait_until代替，使程序在较旧的libstdc++上也能加载
+ */
+template <typename Pred>
+void wait(std::condition_variable& cv,
+          std::unique_lock<std::mutex>& lck,
+          Pred pred) {
+  cv.wait_until(lck, std::chrono::steady_clock::time_point::max(), pred);
+}
+
+}  // namespace utils::thread